@@ -33,6 +33,8 @@
 
 // time stamp byte length
 #define LEN_STAMP 5
+// time stamps and the system time counter wrap at 40 bits
+#define TIME_MASK 0xFFFFFFFFFFull
 
 // enum to determine RX or TX mode of device
 #define IDLE_MODE 0x00
@@ -71,6 +73,7 @@
 #define DIS_STXP_BIT 18
 #define HIRQ_POL_BIT 9
 #define RXAUTR_BIT 29
+#define AUTOACK_BIT 30
 #define PHR_MODE_SUB 16
 #define LEN_PHR_MODE_SUB 2
 #define RXM110K_BIT 22
@@ -113,7 +116,9 @@
 #define RFPLL_LL_BIT 24
 #define CLKPLL_LL_BIT 25
 #define RXSFDTO_BIT 26
+#define HPDWARN_BIT 27
 #define AFFREJ_BIT 29
+#define TXPUTE_BIT 34
 
 // Helper masks. See: See: https://github.com/Decawave/dwm1001-examples/blob/master/deca_driver/deca_regs.h
 // All RX errors mask
@@ -146,8 +151,10 @@
 #define RX_TIME 0x15
 #define LEN_RX_TIME 14
 #define RX_STAMP_SUB 0x00
+#define FP_INDEX_SUB 0x05
 #define FP_AMPL1_SUB 0x07
 #define LEN_RX_STAMP LEN_STAMP
+#define LEN_FP_INDEX 2
 #define LEN_FP_AMPL1 2
 
 // RX frame quality
@@ -162,6 +169,15 @@
 #define LEN_FP_AMPL3 2
 #define LEN_CIR_PWR 2
 
+// receiver time tracking interval
+#define RX_TTCKI 0x13
+#define LEN_RX_TTCKI 4
+
+// receiver time tracking offset (RXTOFS is a 19 bit signed value)
+#define RX_TTCKO 0x14
+#define LEN_RX_TTCKO 5
+#define LEN_RXTOFS 3
+
 // TX timestamp register
 #define TX_TIME 0x17
 #define LEN_TX_TIME 10
@@ -181,6 +197,14 @@
 // Receive frame ait timeout period
 #define RX_FWTO 0x0C
 
+// acknowledgement time and response time
+#define ACK_RESP_T 0x1A
+#define LEN_ACK_RESP_T 4
+#define W4R_TIM_SUB 0x00
+#define LEN_W4R_TIM 3
+#define ACK_TIM_SUB 0x03
+#define LEN_ACK_TIM 1
+
 // RX frame info
 #define RX_FINFO 0x10
 #define LEN_RX_FINFO 4
@@ -206,6 +230,41 @@
 #define SFD_LENGTH_SUB 0x00
 #define LEN_SFD_LENGTH 1
 
+// accumulator memory, channel impulse response of the last received frame.
+// Each sample is a 16 bits real and a 16 bits imaginary part, and each read
+// starts with a dummy byte.
+#define ACC_MEM 0x25
+#define LEN_ACC_MEM 4064
+
+// always-on registers (sleep and wake up configuration)
+#define AON 0x2C
+#define AON_WCFG_SUB 0x00
+#define LEN_AON_WCFG 2
+#define ONW_RADC_BIT 0
+#define ONW_RX_BIT 1
+#define ONW_LEUI_BIT 3
+#define ONW_LDC_BIT 6
+#define ONW_L64P_BIT 7
+#define PRES_SLEEP_BIT 8
+#define ONW_LLDE_BIT 11
+#define ONW_LLDO_BIT 12
+#define AON_CTRL_SUB 0x02
+#define LEN_AON_CTRL 1
+#define RESTORE_BIT 0
+#define SAVE_BIT 1
+#define UPL_CFG_BIT 2
+#define AON_CFG0_SUB 0x06
+#define LEN_AON_CFG0 4
+#define SLEEP_EN_BIT 0
+#define WAKE_PIN_BIT 1
+#define WAKE_SPI_BIT 2
+#define WAKE_CNT_BIT 3
+#define LPDIV_EN_BIT 4
+#define AON_CFG1_SUB 0x0A
+#define LEN_AON_CFG1 2
+#define SLEEP_CEN_BIT 0
+#define LPOSC_CAL_BIT 2
+
 // OTP control (for LDE micro code loading only)
 #define OTP_IF 0x2D
 #define OTP_ADDR_SUB 0x04
@@ -230,12 +289,16 @@
 #define DRX_TUNE1a_SUB 0x04
 #define DRX_TUNE1b_SUB 0x06
 #define DRX_TUNE2_SUB 0x08
+#define DRX_PRETOC_SUB 0x24
 #define DRX_TUNE4H_SUB 0x26
+#define DRX_CAR_INT_SUB 0x28
 #define LEN_DRX_TUNE0b 2
 #define LEN_DRX_TUNE1a 2
 #define LEN_DRX_TUNE1b 2
 #define LEN_DRX_TUNE2 4
+#define LEN_DRX_PRETOC 2
 #define LEN_DRX_TUNE4H 2
+#define LEN_DRX_CAR_INT 3
 
 // LDE_CFG1 (for re-tuning only)
 #define LDE_IF 0x2E
@@ -277,6 +340,14 @@
 #define PMSC 0x36
 #define PMSC_CTRL0_SUB 0x00
 #define LEN_PMSC_CTRL0 4
+#define RXCLKS_MASK 0x0C
+#define RXCLKS_PLL 0x08
+#define FACE_BIT 6
+#define AMCE_BIT 15
+#define PMSC_CTRL1_SUB 0x04
+#define LEN_PMSC_CTRL1 4
+#define ATXSLP_BIT 11
+#define ARXSLP_BIT 12
 #define PMSC_LEDC 0x28
 #define LEN_PMSC_LEDC 4
 
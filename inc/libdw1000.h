@@ -53,11 +53,31 @@ void dwSetUserdata(dwDevice_t* dev, void* userdata);
  */
 void* dwGetUserdata(dwDevice_t* dev);
 
+/**
+ * Lock the device with the lock operation of dwOps_t, to run a sequence of
+ * calls (for instance dwNewTransmit(), dwSetData() and dwStartTransmit())
+ * without the interrupt handler or another task acting on the device in
+ * between. The driver functions lock the device themselves, this is only
+ * needed to group them. Does nothing when no lock operation is set.
+ */
+void dwLock(dwDevice_t* dev);
+void dwUnlock(dwDevice_t* dev);
+
 /**
  * Setup the DW1000
  */
 int dwConfigure(dwDevice_t* dev);
 
+#ifdef DW_STATIC_CONFIG
+/**
+ * Setup the DW1000 in the mode selected at compile time, see
+ * libdw1000StaticConfig.h. Replaces dwConfigure() followed by the
+ * dwNewConfiguration(), dwSetDefaults(), dwEnableMode() and
+ * dwCommitConfiguration() sequence by a bulk write of a const register image.
+ */
+int dwConfigureStatic(dwDevice_t* dev);
+#endif
+
 /**
  * Read and return the device ID, only chip with ID 0xdeca0130 is supported.
  */
@@ -81,6 +101,25 @@ void dwSoftReset(dwDevice_t* dev);
 
 void dwManageLDE(dwDevice_t* dev);
 
+/**
+ * Configures the sleep mode: on wake up the configuration and the LDO tuning
+ * are restored, and the LDE micro-code is reloaded if 'loadLde' is set (needed
+ * to receive). The chip wakes up on the WAKEUP pin or when the SPI chip select
+ * is held low for at least 500us, and needs a few milliseconds before it can
+ * be accessed again.
+ */
+void dwConfigureSleep(dwDevice_t* dev, bool loadLde);
+
+/**
+ * Makes the chip go to sleep by itself as soon as a transmission is done.
+ */
+void dwEnterSleepAfterTransmit(dwDevice_t* dev, bool val);
+
+/**
+ * Saves the configuration in the always-on memory and puts the chip to sleep.
+ */
+void dwEnterSleep(dwDevice_t* dev);
+
 /* ###########################################################################
  * #### DW1000 register read/write ###########################################
  * ######################################################################### */
@@ -111,6 +150,53 @@ void dwWriteTransmitFrameControlRegister(dwDevice_t* dev);
  */
 void dwSetReceiveWaitTimeout(dwDevice_t *dev, uint16_t timeout);
 
+/**
+ * Set the delay between the end of a transmission and the receiver being
+ * turned on when dwWaitForResponse() is used.
+ * @param delay Delay in step of 1.026us (20 bits), 0 turns the receiver on
+ *              right after the transmission.
+ *
+ * @note Written directly to the chip, no dwCommitConfiguration() is needed.
+ */
+void dwSetWaitForResponseDelay(dwDevice_t *dev, uint32_t delay);
+
+/**
+ * Set the preamble detection timeout. The receiver gives up and reports a
+ * receive timeout if no preamble is detected within the timeout.
+ * @param timeout Timeout in units of PAC size symbols or 0 to disable the
+ *                timeout.
+ *
+ * @note Written directly to the chip, no dwCommitConfiguration() is needed.
+ */
+void dwSetPreambleDetectionTimeout(dwDevice_t *dev, uint16_t timeout);
+
+/**
+ * Set the PAN identifier and short address used by the frame filter and by
+ * automatic acknowledgement. Written to the chip by dwCommitConfiguration().
+ */
+void dwSetPanId(dwDevice_t* dev, uint16_t panId);
+void dwSetShortAddress(dwDevice_t* dev, uint16_t address);
+
+/**
+ * Enable automatic acknowledgement. Received frames that pass the frame filter
+ * and request an acknowledgement are acknowledged by the chip without MCU
+ * involvement, the transmission of the acknowledgement does not call the sent
+ * handler. Enabling it also enables frame filtering, the accepted frame types
+ * are selected with the dwSetFrameFilterAllow*() functions.
+ *
+ * @note dwCommitConfiguration() should be called after this function.
+ */
+void dwSetAutoAcknowledge(dwDevice_t* dev, bool val);
+
+/**
+ * Set the turnaround time between the end of a received frame and the start of
+ * the automatic acknowledgement.
+ * @param symbols Turnaround time in preamble symbols.
+ *
+ * @note Written directly to the chip, no dwCommitConfiguration() is needed.
+ */
+void dwSetAutoAcknowledgeTurnaround(dwDevice_t* dev, uint8_t symbols);
+
 void dwSetFrameFilter(dwDevice_t* dev, bool val);
 void dwSetFrameFilterBehaveCoordinator(dwDevice_t* dev, bool val);
 void dwSetFrameFilterAllowBeacon(dwDevice_t* dev, bool val);
@@ -133,16 +219,83 @@ void dwClearInterrupts(dwDevice_t* dev);
 
 void dwIdle(dwDevice_t* dev);
 void dwNewReceive(dwDevice_t* dev);
-void dwStartReceive(dwDevice_t* dev);
+
+/**
+ * Enable the receiver. If a delayed receiver turn-on was set up and the chip
+ * reports it as scheduled too late (HPDWARN) the reception is aborted, the
+ * device goes back to idle and DW_ERROR_LATE_SCHEDULE is returned.
+ */
+int dwStartReceive(dwDevice_t* dev);
 void dwNewTransmit(dwDevice_t* dev);
-void dwStartTransmit(dwDevice_t* dev);
+
+/**
+ * Start the transmission. If a delayed transmission was set up and the chip
+ * reports it as scheduled too late (HPDWARN/TXPUTE) the transmission is
+ * aborted, the device goes back to idle and DW_ERROR_LATE_SCHEDULE is
+ * returned.
+ */
+int dwStartTransmit(dwDevice_t* dev);
+
 void dwNewConfiguration(dwDevice_t* dev);
 void dwCommitConfiguration(dwDevice_t* dev);
 void dwWaitForResponse(dwDevice_t* dev, bool val);
 void dwSuppressFrameCheck(dwDevice_t* dev, bool val);
 void dwUseSmartPower(dwDevice_t* dev, bool smartPower);
 dwTime_t dwSetDelay(dwDevice_t* dev, const dwTime_t* delay);
+
+/**
+ * Set up a delayed TX or RX at reference + delay. The reference is a known
+ * event time, typically the timestamp of the last received or transmitted
+ * frame, so SYS_TIME does not have to be read.
+ * @return The antenna delay adjusted time of the transmission, to be embedded
+ *         in the frame. Zero if the device is idle.
+ */
+dwTime_t dwSetDelayFrom(dwDevice_t* dev, const dwTime_t* reference, const dwTime_t* delay);
+
 void dwSetTxRxTime(dwDevice_t* dev, const dwTime_t futureTime);
+
+/**
+ * Measure the minimum safe reply delay on the running platform, using the
+ * chip system time as time base. The SPI round trip and the driver work of a
+ * delayed reply (status read and acknowledge, RX timestamp read, loading the
+ * reply with dwSetData(), DX_TIME and SYS_CTRL writes) are measured and the
+ * worst case over all iterations is kept. The device must be idle.
+ * The TX buffer, DX_TIME and TX_FCTRL registers of the chip are overwritten
+ * (a preloaded frame, such as a blink, must be loaded again), the driver
+ * state of the device is kept.
+ * @param length Length of the reply payload
+ * @param interruptLatency Worst case time from the IRQ line being asserted to
+ *                         dwHandleInterrupt() being called. The driver can not
+ *                         observe it, it must be provided by the platform.
+ * @param iterations Number of measurements
+ * @param result The measured costs and the recommended minimum reply delay,
+ *               including the preamble and SFD that are sent before the
+ *               delayed TX time.
+ */
+void dwMeasureReplyDelay(dwDevice_t* dev, unsigned int length,
+                         dwTime_t interruptLatency, unsigned int iterations,
+                         dwReplyDelay_t* result);
+
+/**
+ * Air time of a frame with the current data rate, pulse frequency and
+ * preamble length: preamble, SFD, PHR and payload with the Reed-Solomon
+ * parity bits.
+ * @param length Frame length in bytes, including the CRC (as written to
+ *               TX_FCTRL by dwSetData())
+ * @return The air time in device time units
+ */
+dwTime_t dwGetFrameAirtime(dwDevice_t* dev, unsigned int length);
+
+/**
+ * Same as dwGetFrameAirtime(), rounded up to the next microsecond.
+ */
+unsigned int dwGetFrameAirtimeUs(dwDevice_t* dev, unsigned int length);
+
+/**
+ * Duration of the preamble and SFD, sent before the RMARKER, in device time
+ * units.
+ */
+dwTime_t dwGetPreambleDuration(dwDevice_t* dev);
 void dwSetDataRate(dwDevice_t* dev, uint8_t rate);
 void dwSetPulseFrequency(dwDevice_t* dev, uint8_t freq);
 uint8_t dwGetPulseFrequency(dwDevice_t* dev);
@@ -160,12 +313,37 @@ void dwGetReceiveTimestamp(dwDevice_t* dev, dwTime_t* time);
 void dwGetRawReceiveTimestamp(dwDevice_t* dev, dwTime_t* time);
 void dwCorrectTimestamp(dwDevice_t* dev, dwTime_t* timestamp);
 void dwGetSystemTimestamp(dwDevice_t* dev, dwTime_t* time);
-bool dwIsTransmitDone(dwDevice_t* dev);
-bool dwIsReceiveTimestampAvailable(dwDevice_t* dev);
-bool dwIsReceiveDone(dwDevice_t* dev);
-bool dwIsReceiveFailed(dwDevice_t *dev);
-bool dwIsReceiveTimeout(dwDevice_t* dev);
-bool dwIsClockProblem(dwDevice_t* dev);
+
+/* Status queries on the SYS_STATUS value read by dwHandleInterrupt() or
+ * dwReadSystemEventStatusRegister() */
+
+static inline bool dwIsTransmitDone(dwDevice_t* dev) {
+	return (dev->sysstatus & (1ull << TXFRS_BIT)) != 0;
+}
+
+static inline bool dwIsReceiveTimestampAvailable(dwDevice_t* dev) {
+	return (dev->sysstatus & (1ull << LDEDONE_BIT)) != 0;
+}
+
+static inline bool dwIsReceiveDone(dwDevice_t* dev) {
+	if(dev->frameCheck) {
+		return (dev->sysstatus & (1ull << RXFCG_BIT)) != 0;
+	}
+	return (dev->sysstatus & (1ull << RXDFR_BIT)) != 0;
+}
+
+static inline bool dwIsReceiveFailed(dwDevice_t *dev) {
+	return (dev->sysstatus & SYS_STATUS_ALL_RX_ERR) != 0;
+}
+
+static inline bool dwIsReceiveTimeout(dwDevice_t* dev) {
+	return (dev->sysstatus & SYS_STATUS_ALL_RX_TO) != 0;
+}
+
+static inline bool dwIsClockProblem(dwDevice_t* dev) {
+	return (dev->sysstatus & (1ull << CLKPLL_LL_BIT | 1ull << RFPLL_LL_BIT)) != 0;
+}
+
 void dwClearAllStatus(dwDevice_t* dev);
 void dwClearReceiveTimestampAvailableStatus(dwDevice_t* dev);
 void dwClearReceiveStatus(dwDevice_t* dev);
@@ -173,6 +351,74 @@ void dwClearTransmitStatus(dwDevice_t* dev);
 float dwGetReceiveQuality(dwDevice_t* dev);
 float dwGetFirstPathPower(dwDevice_t* dev);
 float dwGetReceivePower(dwDevice_t* dev);
+
+/**
+ * Read the diagnostics of the last received frame in one go.
+ */
+void dwReadReceiveDiagnostics(dwDevice_t* dev, dwRxDiagnostics_t* diag);
+
+/**
+ * Clock offset between the remote transmitter and the local receiver in ppm,
+ * derived from the carrier integrator (DRX_CAR_INT) of the last received
+ * frame. A positive value means that the remote clock runs faster than the
+ * local clock, an interval measured by the remote device is converted to the
+ * local timebase by multiplying it with (1 - ppm * 1e-6).
+ */
+float dwGetClockOffsetPpm(dwDevice_t* dev);
+
+/**
+ * Same as dwGetClockOffsetPpm() but computed from already read diagnostics.
+ */
+float dwDiagnosticsClockOffsetPpm(dwDevice_t* dev, const dwRxDiagnostics_t* diag);
+
+/**
+ * Clock offset in ppm derived from the receiver time tracking registers
+ * (RX_TTCKO/RX_TTCKI), same sign convention as dwGetClockOffsetPpm().
+ */
+float dwDiagnosticsTrackingOffsetPpm(const dwRxDiagnostics_t* diag);
+
+/**
+ * Same as dwGetFirstPathPower() and dwGetReceivePower() but computed from
+ * already read diagnostics, in dBm. A receive power well above the first path
+ * power hints at a non line of sight reception.
+ */
+float dwDiagnosticsFirstPathPower(dwDevice_t* dev, const dwRxDiagnostics_t* diag);
+float dwDiagnosticsReceivePower(dwDevice_t* dev, const dwRxDiagnostics_t* diag);
+
+/**
+ * Same as dwGetReceiveQuality() but computed from already read diagnostics:
+ * ratio of the first path amplitude (FP_AMPL2) to the noise (STD_NOISE).
+ */
+float dwDiagnosticsReceiveQuality(const dwRxDiagnostics_t* diag);
+
+/*
+ * Thresholds of the non line of sight classifier. Below DW_NLOS_LOS_DB of
+ * receive power above the first path power a frame is line of sight, above
+ * DW_NLOS_NLOS_DB it is not. Likewise a receive quality above
+ * DW_NLOS_LOS_QUALITY means a clear first path, below DW_NLOS_NLOS_QUALITY the
+ * first path is hardly detected.
+ */
+#ifndef DW_NLOS_LOS_DB
+#define DW_NLOS_LOS_DB 6.0f
+#endif
+#ifndef DW_NLOS_NLOS_DB
+#define DW_NLOS_NLOS_DB 10.0f
+#endif
+#ifndef DW_NLOS_LOS_QUALITY
+#define DW_NLOS_LOS_QUALITY 10.0f
+#endif
+#ifndef DW_NLOS_NLOS_QUALITY
+#define DW_NLOS_NLOS_QUALITY 3.0f
+#endif
+
+/**
+ * Probability, from 0 to 1, that the last received frame came through a non
+ * line of sight path. Computed from already read diagnostics, from the
+ * difference between the receive and first path powers and from the receive
+ * quality, both interpolated linearly between their thresholds.
+ */
+float dwDiagnosticsNlosProbability(dwDevice_t* dev, const dwRxDiagnostics_t* diag);
+
 void dwEnableMode(dwDevice_t *dev, const uint8_t mode[]);
 void dwTune(dwDevice_t *dev);
 void dwHandleInterrupt(dwDevice_t *dev);
@@ -187,6 +433,24 @@ void dwAttachReceivedHandler(dwDevice_t *dev, dwHandler_t handler);
 void dwAttachReceiveTimeoutHandler(dwDevice_t *dev, dwHandler_t handler);
 void dwAttachReceiveFailedHandler(dwDevice_t *dev, dwHandler_t handler);
 
+/**
+ * Attach a software frame filter, see libdw1000AddressFilter.h. Frames it
+ * rejects are dropped before the received handler is called. NULL, the
+ * default, accepts all the frames.
+ */
+void dwAttachReceiveFilter(dwDevice_t *dev, dwFrameFilter_t filter);
+
+#ifdef DW_COMPACT_DEVICE
+/**
+ * Set the handler table of the device. The table can be shared by several
+ * devices, the dwAttach*() functions then change the handlers of all of them.
+ * After dwInit() the devices use a common default table that the dwAttach*()
+ * functions leave unchanged: a table owned by the caller must be set before
+ * attaching handlers.
+ */
+void dwSetHandlers(dwDevice_t *dev, dwHandlers_t *handlers);
+#endif
+
 void dwSetAntenaDelay(dwDevice_t *dev, dwTime_t delay);
 
 /* Tune the DWM radio parameters */
@@ -205,6 +469,8 @@ char* dwStrError(int error);
 /* Error codes */
 #define DW_ERROR_OK 0
 #define DW_ERROR_WRONG_ID 1
+#define DW_ERROR_LATE_SCHEDULE 2
+#define DW_ERROR_BUS_FULL 3
 
 
 #endif //__LIBDW1000_H__
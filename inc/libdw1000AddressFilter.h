@@ -0,0 +1,94 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_ADDRESSFILTER_H__
+#define __LIBDW1000_ADDRESSFILTER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Software address filter, for devices that must receive frames for several
+ * addresses or PANs while the frame filter of the chip only knows one short
+ * address and PAN (PANADR). Only the MAC header is read from the RX buffer,
+ * frames for other destinations are dropped by dwHandleInterrupt() and the
+ * receiver is re-enabled before the payload is fetched.
+ *
+ * Usage:
+ *   static dwAddressFilter_t filter;
+ *   static bool acceptFrame(dwDevice_t *dev) {
+ *     return dwAddressFilterAccept(dev, &filter);
+ *   }
+ *   ...
+ *   dwAddressFilterInit(&filter);
+ *   dwAddressFilterAddShort(&filter, 0xDECA, 0x0001);
+ *   dwAddressFilterAddShort(&filter, 0xBEEF, 0x0042);
+ *   dwAttachReceiveFilter(dev, acceptFrame);
+ *
+ * The frame filter of the chip must be disabled, or must allow the frames for
+ * all the addresses of the set.
+ */
+
+// Number of slots, must be a power of two. Up to 3/4 of them can be used.
+#ifndef DW_ADDRESS_FILTER_SIZE
+#define DW_ADDRESS_FILTER_SIZE 16
+#endif
+
+#define DW_ADDRESS_FILTER_CAPACITY (DW_ADDRESS_FILTER_SIZE * 3 / 4)
+
+typedef struct dwAddressFilter_s {
+	// Short addresses are stored with their PAN, extended addresses alone
+	uint64_t key[DW_ADDRESS_FILTER_SIZE];
+	uint8_t count;
+	// Accept the frames to the broadcast short address 0xFFFF
+	bool acceptBroadcast;
+} dwAddressFilter_t;
+
+/**
+ * Empties the set. Broadcast frames are accepted.
+ */
+void dwAddressFilterInit(dwAddressFilter_t *filter);
+
+/**
+ * Adds a short address of the PAN 'pan', or an extended address of any PAN.
+ * Frames to the short address in the broadcast PAN 0xFFFF are accepted too.
+ * Return false when DW_ADDRESS_FILTER_CAPACITY addresses are in the set.
+ */
+bool dwAddressFilterAddShort(dwAddressFilter_t *filter, uint16_t pan, uint16_t address);
+bool dwAddressFilterAddExtended(dwAddressFilter_t *filter, uint64_t address);
+
+/**
+ * Checks the destination of the frame starting at 'frame'. 'length' is the
+ * number of bytes of the frame available. Frames without destination address
+ * (acknowledgements, beacons) and frames of the types above MAC command (blinks
+ * of libdw1000Blink.h, beacons of libdw1000ClockSync.h) are accepted.
+ */
+bool dwAddressFilterMatch(const dwAddressFilter_t *filter, const uint8_t *frame, size_t length);
+
+/**
+ * Reads the length of the received frame and its MAC header, with a single
+ * RX_BUFFER read of at most 13 bytes, and checks its destination.
+ */
+bool dwAddressFilterAccept(dwDevice_t *dev, const dwAddressFilter_t *filter);
+
+#endif //__LIBDW1000_ADDRESSFILTER_H__
@@ -0,0 +1,68 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_BLINK_H__
+#define __LIBDW1000_BLINK_H__
+
+#include <stdint.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Blink mode for TDoA tags. The blink frame and its TX_FCTRL value are built
+ * once, the chip then goes to sleep by itself after each transmission. A
+ * blink costs three SPI writes once the chip is awake (TX buffer, TX_FCTRL
+ * and TXSTRT) and the MCU does not have to wait for the end of the
+ * transmission.
+ *
+ * Usage:
+ *   dwConfigure() and the radio configuration, once
+ *   dwBlinkInit()
+ *   dwEnterSleep()
+ *   loop:
+ *     wake the chip up (WAKEUP pin or chip select held low >= 500us)
+ *     wait for the chip to be ready (~3ms, the MCU can sleep meanwhile)
+ *     dwBlinkSend()
+ *
+ * The driver state of the device is not updated by dwBlinkSend().
+ */
+
+// IEEE 802.15.4 blink: frame control, sequence number and 64 bits tag id
+#define DW_BLINK_FRAME_CONTROL 0xC5
+#define DW_BLINK_FRAME_LENGTH 10
+
+typedef struct dwBlink_s {
+	uint8_t frame[DW_BLINK_FRAME_LENGTH];
+	uint8_t txfctrl[LEN_TX_FCTRL];
+} dwBlink_t;
+
+/**
+ * Builds the blink of tag 'tagId' from the current configuration and
+ * configures the chip to sleep after each transmission.
+ */
+void dwBlinkInit(dwDevice_t *dev, dwBlink_t *blink, uint64_t tagId);
+
+/**
+ * Sends a blink, the chip must be awake. Returns as soon as the transmission
+ * is started, the chip goes back to sleep after it.
+ */
+void dwBlinkSend(dwDevice_t *dev, dwBlink_t *blink);
+
+#endif //__LIBDW1000_BLINK_H__
@@ -0,0 +1,148 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_BUS_H__
+#define __LIBDW1000_BUS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Sharing of one SPI bus by several DW1000. Each device gets its own
+ * chip-select and SPI speed, register read-modify-write sequences are run
+ * with the bus locked, and interrupts arriving while the bus is busy are
+ * queued and serviced when it is released. Only available with the default
+ * runtime dispatch of the DW operations.
+ */
+
+#ifndef DW_STATIC_OPS
+
+#define DW_BUS_MAX_DEVICES 16
+
+struct dwBus_s;
+
+/**
+ * Bus operation type. Same as dwOps_t but for the bus, the device is selected
+ * by the chip-select argument.
+ */
+typedef struct dwBusOps_s {
+	/**
+	 * Function that activates the chip-select 'cs', sends header, read data
+	 * and disable the chip-select.
+	 */
+	void (*spiRead)(struct dwBus_s *bus, uint8_t cs, const void *header,
+	                size_t headerLength, void* data, size_t dataLength);
+
+	/**
+	 * Function that activates the chip-select 'cs', sends header, sends data
+	 * and disable the chip-select.
+	 */
+	void (*spiWrite)(struct dwBus_s *bus, uint8_t cs, const void *header,
+	                 size_t headerLength, const void* data, size_t dataLength);
+
+	/**
+	 * Sets the SPI bus speed, see dwOps_t.
+	 */
+	void (*spiSetSpeed)(struct dwBus_s *bus, dwSpiSpeed_t speed);
+
+	/**
+	 * Waits at least 'delay' miliseconds.
+	 */
+	void (*delayms)(struct dwBus_s *bus, unsigned int delay);
+
+	/**
+	 * Waits at least 'delay' microseconds. Optional, see dwOps_t.
+	 */
+	void (*delayus)(struct dwBus_s *bus, unsigned int delay);
+
+	/**
+	 * Resets the DW1000 on chip-select 'cs'. Optional, if not set softreset
+	 * via SPI will be used.
+	 */
+	void (*reset)(struct dwBus_s *bus, uint8_t cs);
+
+	/**
+	 * Lock and unlock the bus, typically with a mutex of the RTOS. Optional
+	 * when the devices are only accessed from one context. The lock must be
+	 * recursive.
+	 */
+	void (*lock)(struct dwBus_s *bus);
+	void (*unlock)(struct dwBus_s *bus);
+
+	/**
+	 * Tries to lock the bus without blocking, returns true on success. Called
+	 * by dwBusHandleInterrupt() so it must be usable from interrupt context.
+	 * Mandatory if lock is set.
+	 */
+	bool (*tryLock)(struct dwBus_s *bus);
+} dwBusOps_t;
+
+/**
+ * Device on a shared bus. The DW1000 context is the first member so that
+ * &busDevice->dev can be used with all the driver functions.
+ */
+typedef struct dwBusDevice_s {
+	dwDevice_t dev;
+	struct dwBus_s *bus;
+	uint8_t cs;
+	uint8_t speed;
+	volatile uint8_t pending;
+} dwBusDevice_t;
+
+/**
+ * Bus type. Contains the devices attached to one SPI bus.
+ */
+typedef struct dwBus_s {
+	const dwBusOps_t *ops;
+	void *userdata;
+	dwBusDevice_t *devices[DW_BUS_MAX_DEVICES];
+	uint8_t deviceCount;
+	uint8_t depth;
+	uint8_t speed;
+} dwBus_t;
+
+/**
+ * Initialize the bus data structure.
+ */
+void dwBusInit(dwBus_t *bus, const dwBusOps_t *ops);
+
+/**
+ * Initialize a device on chip-select 'cs' and attach it to the bus. Replaces
+ * dwInit() for devices on a shared bus.
+ *
+ * @return DW_ERROR_OK, or DW_ERROR_BUS_FULL if DW_BUS_MAX_DEVICES devices are
+ *         already attached.
+ */
+int dwBusAttach(dwBus_t *bus, dwBusDevice_t *busDevice, uint8_t cs);
+
+/**
+ * Interrupt entry point of a device on the bus, to be used instead of
+ * dwHandleInterrupt(). The interrupt is serviced right away if the bus is
+ * free, otherwise it is queued and serviced when the bus is unlocked. The
+ * callbacks of the device are called with the bus locked in both cases.
+ */
+void dwBusHandleInterrupt(dwBusDevice_t *busDevice);
+
+#endif // DW_STATIC_OPS
+
+#endif //__LIBDW1000_BUS_H__
@@ -0,0 +1,90 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_CIR_H__
+#define __LIBDW1000_CIR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Readout of the channel impulse response (CIR) of the last received frame
+ * from the accumulator memory. A window of samples around the first path is
+ * read in chunks of DW_CIR_CHUNK samples, one SPI read per call of
+ * dwCirRead(), so that a long readout can be interleaved with other work.
+ *
+ * Usage:
+ *   in the received handler, before the receiver is enabled again:
+ *     dwCirStart(dev, &reader, samples, 16, 64);
+ *   then, until it returns true:
+ *     dwCirRead(dev, &reader);
+ *
+ * The next reception overwrites the accumulator: the receiver must stay off
+ * until the readout is done. The accumulator clocks are forced on from
+ * dwCirStart() until the last chunk is read or dwCirStop() is called.
+ */
+
+// Samples read per SPI access
+#ifndef DW_CIR_CHUNK
+#define DW_CIR_CHUNK 32
+#endif
+
+// Number of samples in the accumulator, at 16MHz and 64MHz PRF
+#define DW_CIR_LENGTH_16MHZ 992
+#define DW_CIR_LENGTH_64MHZ 1016
+
+typedef struct dwCirSample_s {
+	int16_t real;
+	int16_t imaginary;
+} dwCirSample_t;
+
+typedef struct dwCirReader_s {
+	dwCirSample_t *samples;
+	// First path index (FP_INDEX), in samples with 6 fractional bits
+	uint16_t firstPathIndex;
+	// Accumulator index of samples[0]
+	uint16_t first;
+	uint16_t count;
+	uint16_t read;
+	bool active;
+} dwCirReader_t;
+
+/**
+ * Starts the readout of 'count' samples into 'samples', from 'before' samples
+ * before the first path. The window is clipped to the accumulator, the number
+ * of samples to read is then in reader->count.
+ */
+void dwCirStart(dwDevice_t *dev, dwCirReader_t *reader, dwCirSample_t samples[],
+                unsigned int before, unsigned int count);
+
+/**
+ * Reads the next chunk. Returns true once all the samples have been read, the
+ * accumulator clocks are then released.
+ */
+bool dwCirRead(dwDevice_t *dev, dwCirReader_t *reader);
+
+/**
+ * Aborts the readout and releases the accumulator clocks.
+ */
+void dwCirStop(dwDevice_t *dev, dwCirReader_t *reader);
+
+#endif //__LIBDW1000_CIR_H__
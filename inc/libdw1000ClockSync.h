@@ -0,0 +1,155 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_CLOCKSYNC_H__
+#define __LIBDW1000_CLOCKSYNC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Wireless clock synchronization. A master sends short beacons with delayed
+ * TX, each one carrying its own TX time. A receiver tracks the offset and the
+ * drift of the master clock with a linear regression over the last beacons
+ * and maps its local device time to the network (master) time.
+ *
+ * Timestamps are unwrapped so the 40 bits counter wrap (~17.2s) is handled,
+ * computations are done in double since float can not hold a device time
+ * with sub-nanosecond resolution.
+ */
+
+// Number of beacons in the regression
+#ifndef DW_CLOCKSYNC_WINDOW
+#define DW_CLOCKSYNC_WINDOW 8
+#endif
+
+// Prediction error above which a beacon does not match, in device time units
+// (~1us)
+#ifndef DW_CLOCKSYNC_MAX_ERROR
+#define DW_CLOCKSYNC_MAX_ERROR 63898
+#endif
+
+// Number of consecutive beacons off the prediction that restart the tracking,
+// fewer are dropped as outliers
+#ifndef DW_CLOCKSYNC_MAX_MISMATCHES
+#define DW_CLOCKSYNC_MAX_MISMATCHES 3
+#endif
+
+// Beacon payload: type, master id, sequence number and 40 bits TX time
+#define DW_CLOCKSYNC_BEACON_TYPE 0xC5
+#define DW_CLOCKSYNC_BEACON_LENGTH 8
+
+typedef struct dwClockSync_s {
+	uint8_t masterId;
+	// Time of flight from the master, added to the beacon TX times
+	dwTime_t propagation;
+
+	/* State */
+	uint8_t count;
+	uint8_t head;
+	uint8_t lastSequence;
+	// Consecutive beacons that did not match the prediction
+	uint8_t mismatches;
+	dwTime_t lastLocal;
+	dwTime_t lastMaster;
+	// Unwrapped local time and master - local offset of the beacons
+	int64_t local[DW_CLOCKSYNC_WINDOW];
+	int64_t offset[DW_CLOCKSYNC_WINDOW];
+	// Fitted offset at the last beacon, and drift of the master clock
+	// relative to the local clock (ratio - 1)
+	double fittedOffset;
+	double drift;
+} dwClockSync_t;
+
+/**
+ * Initialize the tracking of master 'masterId'.
+ */
+void dwClockSyncInit(dwClockSync_t *sync, uint8_t masterId);
+
+/**
+ * Sends a beacon 'delay' after the current system time. The beacon carries
+ * the antenna delay adjusted TX time.
+ *
+ * @return DW_ERROR_OK or the error of dwStartTransmit().
+ */
+int dwClockSyncSendBeacon(dwDevice_t *dev, uint8_t masterId, uint8_t sequence,
+                          const dwTime_t *delay);
+
+/**
+ * Encodes a beacon payload, returns its length.
+ */
+unsigned int dwClockSyncEncodeBeacon(uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH],
+                                     uint8_t masterId, uint8_t sequence,
+                                     const dwTime_t *txTime);
+
+/**
+ * Decodes a beacon payload.
+ * @return false if the payload is not a beacon.
+ */
+bool dwClockSyncDecodeBeacon(const uint8_t data[], unsigned int length,
+                             uint8_t *masterId, uint8_t *sequence,
+                             dwTime_t *txTime);
+
+/**
+ * Adds a beacon of the tracked master, with the TX time it carries and the
+ * local RX timestamp.
+ *
+ * A beacon that does not match the prediction is dropped, the tracking
+ * restarts from the last one after DW_CLOCKSYNC_MAX_MISMATCHES of them in a
+ * row.
+ *
+ * @return true if the sample has been used, false if it was dropped or
+ *         restarted the tracking because it did not match the prediction.
+ */
+bool dwClockSyncUpdate(dwClockSync_t *sync, const dwTime_t *masterTx,
+                       const dwTime_t *localRx);
+
+/**
+ * Decodes a received beacon and adds it if it comes from the tracked master.
+ *
+ * @return false if the frame is not a beacon of the master or did not match
+ *         the prediction.
+ */
+bool dwClockSyncHandleBeacon(dwClockSync_t *sync, const uint8_t data[],
+                             unsigned int length, const dwTime_t *localRx);
+
+/**
+ * True when enough beacons have been received to map times.
+ */
+bool dwClockSyncIsSynchronized(const dwClockSync_t *sync);
+
+/**
+ * Maps a local device time, for instance an RX timestamp, to network time.
+ */
+dwTime_t dwClockSyncToNetwork(const dwClockSync_t *sync, const dwTime_t *local);
+
+/**
+ * Maps a network time, for instance a TDMA slot start, to local device time.
+ */
+dwTime_t dwClockSyncToLocal(const dwClockSync_t *sync, const dwTime_t *network);
+
+/**
+ * Drift of the master clock relative to the local clock in ppm.
+ */
+double dwClockSyncDriftPpm(const dwClockSync_t *sync);
+
+#endif //__LIBDW1000_CLOCKSYNC_H__
@@ -0,0 +1,74 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_HASH_H__
+#define __LIBDW1000_HASH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Open addressing set of 64 bits keys with linear probing, used by the tag
+ * table and the address filter. The number of slots is a power of two and
+ * at least one slot is always empty, so that every probe ends on an empty
+ * slot.
+ */
+
+// The broadcast extended address is never a key
+#define DW_HASH_EMPTY 0xFFFFFFFFFFFFFFFFull
+
+// Fibonacci hashing, spreads sequential addresses over the slots
+static inline unsigned int dwHashHome(uint64_t key, unsigned int size) {
+	return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 40) & (size - 1);
+}
+
+/**
+ * Slot of 'key' in the 'size' slots of 'keys', or the empty slot where it
+ * would be added when it is not in the set.
+ */
+static inline unsigned int dwHashProbe(const uint64_t *keys, unsigned int size, uint64_t key) {
+	unsigned int i = dwHashHome(key, size);
+	while(keys[i] != DW_HASH_EMPTY && keys[i] != key) {
+		i = (i + 1) & (size - 1);
+	}
+	return i;
+}
+
+/**
+ * Removal by backward shift, no tombstone is needed: after the slot 'hole'
+ * has been vacated, returns the slot of the next entry that can not be found
+ * anymore through the hole and must be moved into it, or 'size' when none.
+ * The slot of the moved entry is then the next hole.
+ */
+static inline unsigned int dwHashShift(const uint64_t *keys, unsigned int size, unsigned int hole) {
+	unsigned int i = hole;
+	while(true) {
+		i = (i + 1) & (size - 1);
+		if(keys[i] == DW_HASH_EMPTY) {
+			return size;
+		}
+		unsigned int h = dwHashHome(keys[i], size);
+		if(((i - h) & (size - 1)) >= ((i - hole) & (size - 1))) {
+			return i;
+		}
+	}
+}
+
+#endif //__LIBDW1000_HASH_H__
@@ -0,0 +1,114 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_MAC_H__
+#define __LIBDW1000_MAC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * IEEE 802.15.4 MAC header encoding and decoding. The header is built in place
+ * at the start of the TX buffer and parsed directly from the RX buffer, the
+ * payload is never copied: it follows the header in the same buffer.
+ *
+ * Frames with security enabled (auxiliary security header) are not supported.
+ * The FCS is not part of the buffers, it is added and checked by the chip.
+ */
+
+// Frame types
+#define DW_MAC_TYPE_BEACON 0
+#define DW_MAC_TYPE_DATA 1
+#define DW_MAC_TYPE_ACK 2
+#define DW_MAC_TYPE_MAC_COMMAND 3
+
+// Addressing modes
+#define DW_MAC_ADDRESS_NONE 0
+#define DW_MAC_ADDRESS_SHORT 2
+#define DW_MAC_ADDRESS_EXTENDED 3
+
+// Position of the destination addressing mode in the frame control field
+#define DW_MAC_DESTINATION_MODE_SHIFT 10
+
+// Broadcast short address and PAN id
+#define DW_MAC_BROADCAST 0xFFFF
+
+// Frame control, sequence number, two PAN ids and two extended addresses
+#define DW_MAC_MAX_HEADER_LENGTH 23
+
+typedef struct dwMacHeader_s {
+	uint8_t type;
+	bool framePending;
+	bool ackRequest;
+	// Only one PAN id is sent when both addresses are present
+	bool panCompression;
+	uint8_t version;
+	uint8_t destinationMode;
+	uint8_t sourceMode;
+	uint8_t sequence;
+	uint16_t destinationPan;
+	uint16_t sourcePan;
+	// Short addresses use the 16 low bits
+	uint64_t destination;
+	uint64_t source;
+} dwMacHeader_t;
+
+/**
+ * Length of the encoded header.
+ */
+size_t dwMacHeaderLength(const dwMacHeader_t *header);
+
+/**
+ * Writes the header at the start of 'buffer', which must have room for
+ * dwMacHeaderLength() bytes. Returns the header length, the payload goes right
+ * after it.
+ */
+size_t dwMacEncode(uint8_t *buffer, const dwMacHeader_t *header);
+
+/**
+ * Parses the header of the 'length' bytes frame in 'buffer', as returned by
+ * dwGetData(). Returns the header length, the payload starts at this offset,
+ * or 0 if the frame is truncated, uses a reserved addressing mode or is
+ * secured.
+ */
+size_t dwMacDecode(const uint8_t *buffer, size_t length, dwMacHeader_t *header);
+
+/**
+ * Frame type and sequence number read directly from a received frame of at
+ * least 3 bytes, to dispatch frames without decoding the full header.
+ */
+static inline uint8_t dwMacFrameType(const uint8_t *buffer) {
+	return buffer[0] & 0x07;
+}
+
+static inline uint8_t dwMacSequence(const uint8_t *buffer) {
+	return buffer[2];
+}
+
+/**
+ * Destination addressing mode read directly from a received frame of at least
+ * 2 bytes. The destination PAN id and address follow the sequence number.
+ */
+static inline uint8_t dwMacDestinationMode(const uint8_t *buffer) {
+	return (buffer[1] >> (DW_MAC_DESTINATION_MODE_SHIFT - 8)) & 3;
+}
+
+#endif //__LIBDW1000_MAC_H__
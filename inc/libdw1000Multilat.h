@@ -0,0 +1,99 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_MULTILAT_H__
+#define __LIBDW1000_MULTILAT_H__
+
+#include <stdint.h>
+
+#include "dw1000.h"
+
+/*
+ * Multilateration of many tags at once from their ranges to a set of anchors,
+ * meant for gateways collecting the ranges of all the tags. The ranges and
+ * positions are stored as one array per coordinate (structure of arrays) and
+ * the tags are solved by blocks of DW_MULTILAT_BLOCK: the Gauss-Newton loops
+ * run over the tags of a block with no branches, so that the compiler can
+ * vectorize them. Each tag starts from its previous position, or from below
+ * the anchors for a new tag, a block stops iterating as soon as all its tags
+ * have converged.
+ *
+ * Building with DW_MULTILAT_THREADS=n (and -pthread) solves the blocks on n
+ * threads.
+ */
+
+#ifndef DW_MULTILAT_MAX_ANCHORS
+#define DW_MULTILAT_MAX_ANCHORS 16
+#endif
+
+// Number of tags solved together
+#ifndef DW_MULTILAT_BLOCK
+#define DW_MULTILAT_BLOCK 64
+#endif
+
+// Maximum number of Gauss-Newton iterations
+#ifndef DW_MULTILAT_ITERATIONS
+#define DW_MULTILAT_ITERATIONS 10
+#endif
+
+// Position update below which a tag has converged, in meters
+#ifndef DW_MULTILAT_TOLERANCE
+#define DW_MULTILAT_TOLERANCE 0.001f
+#endif
+
+// Start height of a new tag relative to the centroid of the anchors, in
+// meters. With coplanar anchors a tag and its mirror image through their plane
+// have the same ranges: the sign selects the solution, below the anchors by
+// default. Must not be 0.
+#ifndef DW_MULTILAT_START_HEIGHT
+#define DW_MULTILAT_START_HEIGHT -1.0f
+#endif
+
+typedef struct dwMultilatAnchors_s {
+	// Anchor positions in meters
+	float x[DW_MULTILAT_MAX_ANCHORS];
+	float y[DW_MULTILAT_MAX_ANCHORS];
+	float z[DW_MULTILAT_MAX_ANCHORS];
+	int count;
+} dwMultilatAnchors_t;
+
+typedef struct dwMultilatBatch_s {
+	// Time of flight between tag t and anchor a at tof[a * stride + t], in
+	// device time units (converted with DISTANCE_OF_RADIO). 0 when the range
+	// was not measured.
+	const float *tof;
+	int stride;
+	// Positions of the tags in meters. Hold the previous solution, or NAN for
+	// a new tag, and are updated by dwMultilatSolve().
+	float *x;
+	float *y;
+	float *z;
+	// RMS range residual of each tag in meters, or NAN if the tag has less than
+	// 4 ranges and was not solved. Optional, can be NULL.
+	float *residual;
+	int tagCount;
+} dwMultilatBatch_t;
+
+/**
+ * Solves the positions of all the tags of the batch.
+ */
+void dwMultilatSolve(const dwMultilatAnchors_t *anchors, dwMultilatBatch_t *batch);
+
+#endif //__LIBDW1000_MULTILAT_H__
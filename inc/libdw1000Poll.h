@@ -0,0 +1,66 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_POLL_H__
+#define __LIBDW1000_POLL_H__
+
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * Polling engine for boards where the DW1000 IRQ line is not connected. The
+ * engine waits until the end of the expected frame, computed by
+ * dwGetFrameAirtimeUs(), and then polls SYS_STATUS with an exponentially
+ * growing interval. Waits use the delayus operation of dwOps_t.
+ */
+
+// First polling interval after the expected event time, in microseconds
+#ifndef DW_POLL_MIN_INTERVAL_US
+#define DW_POLL_MIN_INTERVAL_US 16
+#endif
+
+// Limit of the polling interval, in microseconds
+#ifndef DW_POLL_MAX_INTERVAL_US
+#define DW_POLL_MAX_INTERVAL_US 1024
+#endif
+
+/**
+ * Waits for the end of the transmission started by dwStartTransmit(), then
+ * handles it as dwHandleInterrupt() would.
+ *
+ * @param timeoutUs Time after which polling gives up, in microseconds.
+ * @return true if an event has been handled, false on timeout.
+ */
+bool dwPollTransmit(dwDevice_t* dev, unsigned int timeoutUs);
+
+/**
+ * Waits for a frame after dwStartReceive() and handles it as
+ * dwHandleInterrupt() would. Polling starts once a frame of 'expectedLength'
+ * bytes could have been received.
+ *
+ * @param expectedLength Payload length of the shortest expected frame, without
+ *                       the CRC.
+ * @param timeoutUs Time after which polling gives up, in microseconds.
+ * @return true if an event has been handled, false on timeout.
+ */
+bool dwPollReceive(dwDevice_t* dev, unsigned int expectedLength, unsigned int timeoutUs);
+
+#endif //__LIBDW1000_POLL_H__
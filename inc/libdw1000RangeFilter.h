@@ -0,0 +1,88 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_RANGEFILTER_H__
+#define __LIBDW1000_RANGEFILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Filter of the ranges measured on one link (one pair of devices), the
+ * application keeps one dwRangeFilter_t per link. Each new range goes through:
+ *   - a quality gate: ranges whose receive power is more than
+ *     maxPowerDifference dB above the first path power are likely non line of
+ *     sight and are rejected, see dwDiagnosticsReceivePower() and
+ *     dwDiagnosticsFirstPathPower()
+ *   - a Hampel filter over the last DW_RANGE_FILTER_WINDOW ranges: ranges
+ *     further than outlierThreshold scaled median absolute deviations from the
+ *     median are rejected
+ *   - optionally a constant velocity Kalman filter.
+ * The filtered range is the median of the window, or the Kalman estimate.
+ */
+
+// Number of ranges in the sliding window, odd
+#ifndef DW_RANGE_FILTER_WINDOW
+#define DW_RANGE_FILTER_WINDOW 5
+#endif
+
+typedef struct dwRangeFilter_s {
+	// Configuration, set to defaults by dwRangeFilterInit()
+	float maxPowerDifference;   // dB
+	float outlierThreshold;     // Scaled median absolute deviations
+	float minDeviation;         // m, lower bound of the outlier threshold
+	bool kalman;
+	float processNoise;         // Acceleration variance, (m/s^2)^2
+	float measurementNoise;     // Range variance, m^2
+
+	// Ranges in arrival order (ring) and sorted
+	float window[DW_RANGE_FILTER_WINDOW];
+	float sorted[DW_RANGE_FILTER_WINDOW];
+	uint8_t head;
+	uint8_t count;
+
+	// Estimate, valid once a range has been accepted
+	bool valid;
+	float range;                // m
+	float velocity;             // m/s, with the Kalman filter only
+	float covariance[3];        // Kalman covariance: range, cross, velocity
+	float time;                 // s, time of the last accepted range
+} dwRangeFilter_t;
+
+/**
+ * Empties the filter and sets the default configuration: 10dB power
+ * difference, 3 deviations with at least 0.1m, Kalman filter disabled with a
+ * process noise of 1 (m/s^2)^2 and a measurement noise of 0.01m^2.
+ */
+void dwRangeFilterInit(dwRangeFilter_t *filter);
+
+/**
+ * Forgets the past ranges, the configuration is kept.
+ */
+void dwRangeFilterReset(dwRangeFilter_t *filter);
+
+/**
+ * Adds the range 'range' (m) measured at 'time' (s) with 'powerDifference'
+ * (receive power minus first path power, dB). Returns true if the range was
+ * accepted, the filtered range is then in filter->range.
+ */
+bool dwRangeFilterUpdate(dwRangeFilter_t *filter, float range, float time, float powerDifference);
+
+#endif //__LIBDW1000_RANGEFILTER_H__
@@ -28,18 +28,62 @@
 #include "dw1000.h"
 #include "libdw1000Types.h"
 
+/**
+ * Precomputed SPI transaction header. Initialize with DW_SPI_HEADER_READ() or
+ * DW_SPI_HEADER_WRITE() so that the header of a fixed register access is
+ * computed at compile time.
+ */
+typedef struct dwSpiHeader_s {
+	uint8_t bytes[3];
+	uint8_t length;
+} dwSpiHeader_t;
+
+#define DW_SPI_HEADER_BYTE0(regid, address, write) \
+	((uint8_t)(((regid) & 0x3f) | ((write)?0x80:0) | ((address)!=0?0x40:0)))
+#define DW_SPI_HEADER_BYTE1(address) \
+	((uint8_t)(((address) & 0x7f) | (((address) >> 7)!=0?0x80:0)))
+#define DW_SPI_HEADER_BYTE2(address) ((uint8_t)(((address) >> 7) & 0xff))
+#define DW_SPI_HEADER_LENGTH(address) \
+	((uint8_t)((address)==0?1:(((address) >> 7)==0?2:3)))
+
+#define DW_SPI_HEADER(regid, address, write) { \
+	.bytes = {DW_SPI_HEADER_BYTE0(regid, address, write), \
+	          DW_SPI_HEADER_BYTE1(address), DW_SPI_HEADER_BYTE2(address)}, \
+	.length = DW_SPI_HEADER_LENGTH(address)}
+#define DW_SPI_HEADER_READ(regid, address) DW_SPI_HEADER(regid, address, false)
+#define DW_SPI_HEADER_WRITE(regid, address) DW_SPI_HEADER(regid, address, true)
+
+#ifdef DW_STATIC_OPS
+// dwSpiRead(), dwSpiWrite() and their precomputed header variants are defined
+// inline
+#include "libdw1000SpiInline.h"
+#else
 /**
  * Read from the dw1000 SPI interface
  */
 void dwSpiRead(dwDevice_t *dev, uint8_t regid, uint32_t address, void* data, size_t length);
+#endif
 uint16_t dwSpiRead16(dwDevice_t *dev, uint8_t regid, uint32_t address);
 uint32_t dwSpiRead32(dwDevice_t *dev, uint8_t regid, uint32_t address);
 
+#ifndef DW_STATIC_OPS
 /**
  * Write to the dw1000 SPI interface
  */
 void dwSpiWrite(dwDevice_t *dev, uint8_t regid, uint32_t address,
                                  const void* data, size_t length);
+#endif
+
+#ifndef DW_STATIC_OPS
+/**
+ * Read and write using a precomputed header, see DW_SPI_HEADER_READ() and
+ * DW_SPI_HEADER_WRITE()
+ */
+void dwSpiReadHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                      void* data, size_t length);
+void dwSpiWriteHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                       const void* data, size_t length);
+#endif
 
 void dwSpiWrite8(dwDevice_t *dev, uint8_t regid, uint32_t address,
                                    uint8_t data);
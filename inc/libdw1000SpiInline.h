@@ -0,0 +1,92 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_SPI_INLINE_H__
+#define __LIBDW1000_SPI_INLINE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dw1000.h"
+#include "libdw1000Types.h"
+#include "libdw1000Spi.h"
+
+/**
+ * Builds the 1 to 3 bytes SPI transaction header accessing 'address' of
+ * register 'regid'. Returns the header length.
+ */
+static inline size_t dwSpiHeader(uint8_t header[3], uint8_t regid,
+                                 uint32_t address, bool write) {
+	size_t headerLength=1;
+
+	header[0] = regid & 0x3f;
+	if (write) {
+		header[0] |= 0x80;
+	}
+
+	if (address != 0) {
+		header[0] |= 0x40;
+
+		header[1] = address & 0x7f;
+		address >>= 7;
+		headerLength = 2;
+
+		if (address != 0) {
+			header[1] |= 0x80;
+			header[2] = address & 0xff;
+			headerLength = 3;
+		}
+	}
+
+	return headerLength;
+}
+
+#ifdef DW_STATIC_OPS
+// With static dispatch the accessors are inlined, for constant register and
+// address the header is then computed at compile time.
+static inline void dwSpiRead(dwDevice_t *dev, uint8_t regid, uint32_t address,
+                                              void* data, size_t length) {
+	uint8_t header[3];
+	size_t headerLength = dwSpiHeader(header, regid, address, false);
+
+	DW_OPS_SPI_READ(dev, header, headerLength, data, length);
+}
+
+static inline void dwSpiWrite(dwDevice_t *dev, uint8_t regid, uint32_t address,
+                                               const void* data, size_t length) {
+	uint8_t header[3];
+	size_t headerLength = dwSpiHeader(header, regid, address, true);
+
+	DW_OPS_SPI_WRITE(dev, header, headerLength, data, length);
+}
+
+static inline void dwSpiReadHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                                    void* data, size_t length) {
+	DW_OPS_SPI_READ(dev, header->bytes, header->length, data, length);
+}
+
+static inline void dwSpiWriteHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                                     const void* data, size_t length) {
+	DW_OPS_SPI_WRITE(dev, header->bytes, header->length, data, length);
+}
+#endif
+
+#endif //__LIBDW1000_SPI_INLINE_H__
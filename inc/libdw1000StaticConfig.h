@@ -0,0 +1,256 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Compile-time radio configuration used by dwConfigureStatic(), available when
+ * the driver is built with DW_STATIC_CONFIG.
+ *
+ * The mode is selected by defining the DW_CONFIG_* macros below on the
+ * compiler command line (or in a header force-included by the build), the
+ * complete register image is then computed by the preprocessor following the
+ * same rules as dwTune(). Unset macros take the values used by dwSetDefaults().
+ */
+
+#ifndef __LIBDW1000_STATIC_CONFIG_H__
+#define __LIBDW1000_STATIC_CONFIG_H__
+
+#include "dw1000.h"
+
+#ifndef DW_CONFIG_DATA_RATE
+#define DW_CONFIG_DATA_RATE TRX_RATE_110KBPS
+#endif
+#ifndef DW_CONFIG_PULSE_FREQ
+#define DW_CONFIG_PULSE_FREQ TX_PULSE_FREQ_16MHZ
+#endif
+#ifndef DW_CONFIG_PREAMBLE_LENGTH
+#define DW_CONFIG_PREAMBLE_LENGTH TX_PREAMBLE_LEN_2048
+#endif
+#ifndef DW_CONFIG_CHANNEL
+#define DW_CONFIG_CHANNEL CHANNEL_5
+#endif
+#ifndef DW_CONFIG_PREAMBLE_CODE
+#if DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ
+#define DW_CONFIG_PREAMBLE_CODE PREAMBLE_CODE_16MHZ_4
+#else
+#define DW_CONFIG_PREAMBLE_CODE PREAMBLE_CODE_64MHZ_10
+#endif
+#endif
+#ifndef DW_CONFIG_SMART_POWER
+#define DW_CONFIG_SMART_POWER 0
+#endif
+// DW_CONFIG_TX_POWER can be defined to force the TX_POWER register value
+#ifndef DW_CONFIG_ANTENNA_DELAY
+#define DW_CONFIG_ANTENNA_DELAY 16384
+#endif
+#ifndef DW_CONFIG_SYS_MASK
+#define DW_CONFIG_SYS_MASK (1ul << TXFRS_BIT | 1ul << RXDFR_BIT | 1ul << RXFCG_BIT | \
+                            1ul << RXRFTO_BIT | 1ul << RXPTO_BIT)
+#endif
+
+/* Configuration registers */
+
+#if DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_64 || DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_128
+#define DW_CONFIG_PAC_SIZE PAC_SIZE_8
+#elif DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_256 || DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_512
+#define DW_CONFIG_PAC_SIZE PAC_SIZE_16
+#elif DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_1024
+#define DW_CONFIG_PAC_SIZE PAC_SIZE_32
+#else
+#define DW_CONFIG_PAC_SIZE PAC_SIZE_64
+#endif
+
+#define DW_CONFIG_SYS_CFG (1ul << DIS_DRXB_BIT | 1ul << HIRQ_POL_BIT | 1ul << RXAUTR_BIT | \
+	(DW_CONFIG_SMART_POWER ? 0 : 1ul << DIS_STXP_BIT) | \
+	(DW_CONFIG_DATA_RATE == TRX_RATE_110KBPS ? 1ul << RXM110K_BIT : 0))
+
+#define DW_CONFIG_CHAN_CTRL ((uint32_t)DW_CONFIG_CHANNEL | (uint32_t)DW_CONFIG_CHANNEL << 4 | \
+	(DW_CONFIG_DATA_RATE == TRX_RATE_6800KBPS ? 0 : 1ul << DWSFD_BIT | 1ul << TNSSFD_BIT | 1ul << RNSSFD_BIT) | \
+	(uint32_t)DW_CONFIG_PULSE_FREQ << 18 | \
+	(uint32_t)DW_CONFIG_PREAMBLE_CODE << 22 | (uint32_t)DW_CONFIG_PREAMBLE_CODE << 27)
+
+// Frame length is set per frame by dwSetData()
+#define DW_CONFIG_TX_FCTRL ((uint32_t)DW_CONFIG_DATA_RATE << 13 | \
+	(uint32_t)DW_CONFIG_PULSE_FREQ << 16 | (uint32_t)DW_CONFIG_PREAMBLE_LENGTH << 18)
+
+#if DW_CONFIG_DATA_RATE == TRX_RATE_6800KBPS
+#define DW_CONFIG_SFD_LENGTH 0x08
+#elif DW_CONFIG_DATA_RATE == TRX_RATE_850KBPS
+#define DW_CONFIG_SFD_LENGTH 0x10
+#else
+#define DW_CONFIG_SFD_LENGTH 0x40
+#endif
+
+/* Tuning registers, see dwTune() */
+
+#if DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ
+#define DW_CONFIG_AGC_TUNE1 0x8870
+#define DW_CONFIG_DRX_TUNE1a 0x0087
+#define DW_CONFIG_LDE_CFG2 0x1607
+#elif DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_64MHZ
+#define DW_CONFIG_AGC_TUNE1 0x889B
+#define DW_CONFIG_DRX_TUNE1a 0x008D
+#define DW_CONFIG_LDE_CFG2 0x0607
+#else
+#error "Unsupported DW_CONFIG_PULSE_FREQ"
+#endif
+
+#define DW_CONFIG_AGC_TUNE2 0x2502A907ul
+#define DW_CONFIG_AGC_TUNE3 0x0035
+#define DW_CONFIG_LDE_CFG1 0xD
+
+#if DW_CONFIG_DATA_RATE == TRX_RATE_110KBPS
+#define DW_CONFIG_DRX_TUNE0b 0x0016
+#elif DW_CONFIG_DATA_RATE == TRX_RATE_850KBPS
+#define DW_CONFIG_DRX_TUNE0b 0x0006
+#elif DW_CONFIG_DATA_RATE == TRX_RATE_6800KBPS
+#define DW_CONFIG_DRX_TUNE0b 0x0001
+#else
+#error "Unsupported DW_CONFIG_DATA_RATE"
+#endif
+
+#if DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_1536 || DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_2048 || \
+		DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_4096
+#if DW_CONFIG_DATA_RATE == TRX_RATE_110KBPS
+#define DW_CONFIG_DRX_TUNE1b 0x0064
+#endif
+#elif DW_CONFIG_PREAMBLE_LENGTH != TX_PREAMBLE_LEN_64
+#if DW_CONFIG_DATA_RATE == TRX_RATE_850KBPS || DW_CONFIG_DATA_RATE == TRX_RATE_6800KBPS
+#define DW_CONFIG_DRX_TUNE1b 0x0020
+#endif
+#else
+#if DW_CONFIG_DATA_RATE == TRX_RATE_6800KBPS
+#define DW_CONFIG_DRX_TUNE1b 0x0010
+#endif
+#endif
+#ifndef DW_CONFIG_DRX_TUNE1b
+#error "Unsupported DW_CONFIG_PREAMBLE_LENGTH and DW_CONFIG_DATA_RATE combination"
+#endif
+
+#if DW_CONFIG_PAC_SIZE == PAC_SIZE_8
+#define DW_CONFIG_DRX_TUNE2 (DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ ? 0x311A002Dul : 0x313B006Bul)
+#elif DW_CONFIG_PAC_SIZE == PAC_SIZE_16
+#define DW_CONFIG_DRX_TUNE2 (DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ ? 0x331A0052ul : 0x333B00BEul)
+#elif DW_CONFIG_PAC_SIZE == PAC_SIZE_32
+#define DW_CONFIG_DRX_TUNE2 (DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ ? 0x351A009Aul : 0x353B015Eul)
+#else
+#define DW_CONFIG_DRX_TUNE2 (DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ ? 0x371A011Dul : 0x373B0296ul)
+#endif
+
+#if DW_CONFIG_PREAMBLE_LENGTH == TX_PREAMBLE_LEN_64
+#define DW_CONFIG_DRX_TUNE4H 0x0010
+#else
+#define DW_CONFIG_DRX_TUNE4H 0x0028
+#endif
+
+#if DW_CONFIG_CHANNEL == CHANNEL_1
+#define DW_CONFIG_RF_TXCTRL 0x00005C40ul
+#define DW_CONFIG_TC_PGDELAY 0xC9
+#define DW_CONFIG_FS_PLLCFG 0x09000407ul
+#define DW_CONFIG_FS_PLLTUNE 0x1E
+#elif DW_CONFIG_CHANNEL == CHANNEL_2
+#define DW_CONFIG_RF_TXCTRL 0x00045CA0ul
+#define DW_CONFIG_TC_PGDELAY 0xC2
+#define DW_CONFIG_FS_PLLCFG 0x08400508ul
+#define DW_CONFIG_FS_PLLTUNE 0x26
+#elif DW_CONFIG_CHANNEL == CHANNEL_3
+#define DW_CONFIG_RF_TXCTRL 0x00086CC0ul
+#define DW_CONFIG_TC_PGDELAY 0xC5
+#define DW_CONFIG_FS_PLLCFG 0x08401009ul
+#define DW_CONFIG_FS_PLLTUNE 0x56
+#elif DW_CONFIG_CHANNEL == CHANNEL_4
+#define DW_CONFIG_RF_TXCTRL 0x00045C80ul
+#define DW_CONFIG_TC_PGDELAY 0x95
+#define DW_CONFIG_FS_PLLCFG 0x08400508ul
+#define DW_CONFIG_FS_PLLTUNE 0x26
+#elif DW_CONFIG_CHANNEL == CHANNEL_5
+#define DW_CONFIG_RF_TXCTRL 0x001E3FE0ul
+#define DW_CONFIG_TC_PGDELAY 0xC0
+#define DW_CONFIG_FS_PLLCFG 0x0800041Dul
+#define DW_CONFIG_FS_PLLTUNE 0xA6
+#elif DW_CONFIG_CHANNEL == CHANNEL_7
+#define DW_CONFIG_RF_TXCTRL 0x001E7DE0ul
+#define DW_CONFIG_TC_PGDELAY 0x93
+#define DW_CONFIG_FS_PLLCFG 0x0800041Dul
+#define DW_CONFIG_FS_PLLTUNE 0xA6
+#else
+#error "Unsupported DW_CONFIG_CHANNEL"
+#endif
+
+#if DW_CONFIG_CHANNEL == CHANNEL_4 || DW_CONFIG_CHANNEL == CHANNEL_7
+#define DW_CONFIG_RF_RXCTRLH 0xBC
+#else
+#define DW_CONFIG_RF_RXCTRLH 0xD8
+#endif
+
+#if DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_1 || DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_2
+#define DW_CONFIG_LDE_REPC_VALUE 0x5998
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_3 || DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_8
+#define DW_CONFIG_LDE_REPC_VALUE 0x51EA
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_4
+#define DW_CONFIG_LDE_REPC_VALUE 0x428E
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_5
+#define DW_CONFIG_LDE_REPC_VALUE 0x451E
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_6
+#define DW_CONFIG_LDE_REPC_VALUE 0x2E14
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_16MHZ_7
+#define DW_CONFIG_LDE_REPC_VALUE 0x8000
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_9
+#define DW_CONFIG_LDE_REPC_VALUE 0x28F4
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_10 || DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_17
+#define DW_CONFIG_LDE_REPC_VALUE 0x3332
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_11
+#define DW_CONFIG_LDE_REPC_VALUE 0x3AE0
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_12
+#define DW_CONFIG_LDE_REPC_VALUE 0x3D70
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_18 || DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_19
+#define DW_CONFIG_LDE_REPC_VALUE 0x35C2
+#elif DW_CONFIG_PREAMBLE_CODE == PREAMBLE_CODE_64MHZ_20
+#define DW_CONFIG_LDE_REPC_VALUE 0x47AE
+#else
+#error "Unsupported DW_CONFIG_PREAMBLE_CODE"
+#endif
+#if DW_CONFIG_DATA_RATE == TRX_RATE_110KBPS
+#define DW_CONFIG_LDE_REPC ((DW_CONFIG_LDE_REPC_VALUE >> 3) & 0xFFFF)
+#else
+#define DW_CONFIG_LDE_REPC DW_CONFIG_LDE_REPC_VALUE
+#endif
+
+#ifndef DW_CONFIG_TX_POWER
+#if DW_CONFIG_CHANNEL == CHANNEL_1 || DW_CONFIG_CHANNEL == CHANNEL_2
+#define DW_CONFIG_TX_POWER_16MHZ (DW_CONFIG_SMART_POWER ? 0x15355575ul : 0x75757575ul)
+#define DW_CONFIG_TX_POWER_64MHZ (DW_CONFIG_SMART_POWER ? 0x07274767ul : 0x67676767ul)
+#elif DW_CONFIG_CHANNEL == CHANNEL_3
+#define DW_CONFIG_TX_POWER_16MHZ (DW_CONFIG_SMART_POWER ? 0x0F2F4F6Ful : 0x6F6F6F6Ful)
+#define DW_CONFIG_TX_POWER_64MHZ (DW_CONFIG_SMART_POWER ? 0x2B4B6B8Bul : 0x8B8B8B8Bul)
+#elif DW_CONFIG_CHANNEL == CHANNEL_4
+#define DW_CONFIG_TX_POWER_16MHZ (DW_CONFIG_SMART_POWER ? 0x1F1F3F5Ful : 0x5F5F5F5Ful)
+#define DW_CONFIG_TX_POWER_64MHZ (DW_CONFIG_SMART_POWER ? 0x3A5A7A9Aul : 0x9A9A9A9Aul)
+#elif DW_CONFIG_CHANNEL == CHANNEL_5
+#define DW_CONFIG_TX_POWER_16MHZ (DW_CONFIG_SMART_POWER ? 0x0E082848ul : 0x48484848ul)
+#define DW_CONFIG_TX_POWER_64MHZ (DW_CONFIG_SMART_POWER ? 0x25456585ul : 0x85858585ul)
+#else
+#define DW_CONFIG_TX_POWER_16MHZ (DW_CONFIG_SMART_POWER ? 0x32527292ul : 0x92929292ul)
+#define DW_CONFIG_TX_POWER_64MHZ (DW_CONFIG_SMART_POWER ? 0x5171B1D1ul : 0xD1D1D1D1ul)
+#endif
+#define DW_CONFIG_TX_POWER (DW_CONFIG_PULSE_FREQ == TX_PULSE_FREQ_16MHZ ? \
+	DW_CONFIG_TX_POWER_16MHZ : DW_CONFIG_TX_POWER_64MHZ)
+#endif
+
+#endif //__LIBDW1000_STATIC_CONFIG_H__
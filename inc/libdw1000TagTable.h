@@ -0,0 +1,85 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_TAGTABLE_H__
+#define __LIBDW1000_TAGTABLE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000RangeFilter.h"
+
+/*
+ * Fixed capacity table of the tags an anchor ranges with. Entries are found by
+ * source address with open addressing (linear probing), in constant time from
+ * the RX path. The per-tag state is stored as one array per field so that a
+ * lookup only touches the address array.
+ */
+
+// Number of slots, must be a power of two. Up to 3/4 of them can be used.
+#ifndef DW_TAG_TABLE_SIZE
+#define DW_TAG_TABLE_SIZE 64
+#endif
+
+#define DW_TAG_TABLE_CAPACITY (DW_TAG_TABLE_SIZE * 3 / 4)
+
+// Key of a 16 bits short address, 64 bits addresses are used as they are
+#define DW_TAG_SHORT_ADDRESS(address) (0xFFFF000000000000ull | (uint16_t)(address))
+
+typedef struct dwTagTable_s {
+	uint64_t address[DW_TAG_TABLE_SIZE];
+	// Sequence number of the last frame of the tag
+	uint8_t sequence[DW_TAG_TABLE_SIZE];
+	// Timestamps of the ranging exchange in progress, in device time units
+	uint64_t pollRx[DW_TAG_TABLE_SIZE];
+	uint64_t answerTx[DW_TAG_TABLE_SIZE];
+	uint64_t finalRx[DW_TAG_TABLE_SIZE];
+	// Last range to the tag, in meters
+	float range[DW_TAG_TABLE_SIZE];
+	// Filter of the ranges to the tag, with the default configuration when
+	// the tag is added
+	dwRangeFilter_t filter[DW_TAG_TABLE_SIZE];
+	uint16_t count;
+} dwTagTable_t;
+
+/**
+ * Empties the table.
+ */
+void dwTagTableInit(dwTagTable_t *table);
+
+/**
+ * Index of the tag with 'address', or -1 if it is not in the table.
+ */
+int dwTagTableFind(const dwTagTable_t *table, uint64_t address);
+
+/**
+ * Index of the tag with 'address', added with a cleared state if it is not in
+ * the table yet. Returns -1 when DW_TAG_TABLE_CAPACITY tags are in the table,
+ * or for the reserved address 0xFFFFFFFFFFFFFFFF.
+ */
+int dwTagTableInsert(dwTagTable_t *table, uint64_t address);
+
+/**
+ * Removes the tag at 'index', invalid indexes are ignored. The index of other
+ * tags can change.
+ */
+void dwTagTableRemove(dwTagTable_t *table, int index);
+
+#endif //__LIBDW1000_TAGTABLE_H__
@@ -0,0 +1,132 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDW1000_TDMA_H__
+#define __LIBDW1000_TDMA_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "libdw1000Types.h"
+
+/*
+ * TDMA superframe scheduler. The superframe is a fixed sequence of slots of
+ * equal length, each slot is idle, transmitted by this node or received from
+ * another node. Slot times are derived from the previous slot start, without
+ * reading SYS_TIME, and every slot is programmed in DX_TIME as a delayed TX
+ * or RX as soon as the previous one is done. The frame of a TX slot following
+ * an RX slot is loaded while the receiver is waiting.
+ *
+ * The scheduler uses the handlers and the userdata pointer of the device. With
+ * DW_COMPACT_DEVICE the device is given the handler table of the scheduler.
+ * The slot start is the RMARKER time of the frame sent in the slot, the
+ * receiver of an RX slot is enabled 'guard' before the preamble of the
+ * expected frame.
+ */
+
+#define DW_TDMA_MAX_FRAME_LENGTH 125
+
+typedef enum {dwTdmaSlotIdle, dwTdmaSlotTx, dwTdmaSlotRx} dwTdmaSlotType_t;
+
+typedef struct dwTdmaSlot_s {
+	uint8_t type;		// dwTdmaSlotType_t
+	uint8_t owner;	// Id of the transmitting node
+} dwTdmaSlot_t;
+
+typedef struct dwTdmaSuperframe_s {
+	const dwTdmaSlot_t *slots;
+	uint8_t slotCount;
+	// Slot length in device time units, see dwTdmaMinimumSlotLength()
+	dwTime_t slotLength;
+	// Receiver turn-on margin before the expected preamble. Covers the clock
+	// drift between two synchronizations and the time needed to program the
+	// next slot, see dwMeasureReplyDelay()
+	dwTime_t guard;
+	// Frames received from this owner re-synchronize the superframe
+	uint8_t syncOwner;
+} dwTdmaSuperframe_t;
+
+struct dwTdma_s;
+
+/**
+ * Called ahead of a TX slot to fill its frame.
+ * @return The payload length, 0 to leave the slot idle.
+ */
+typedef unsigned int (*dwTdmaPrepareTx_t)(struct dwTdma_s *tdma, uint8_t slot,
+                                           uint8_t data[DW_TDMA_MAX_FRAME_LENGTH]);
+
+/**
+ * Called when a frame has been received in an RX slot. The frame can be read
+ * with dwGetDataLength() and dwGetData().
+ */
+typedef void (*dwTdmaReceived_t)(struct dwTdma_s *tdma, uint8_t slot);
+
+typedef struct dwTdma_s {
+	dwDevice_t *dev;
+	const dwTdmaSuperframe_t *superframe;
+	dwTdmaPrepareTx_t prepareTx;
+	dwTdmaReceived_t received;
+	void *userdata;
+
+	/* State */
+	bool running;
+	uint8_t slot;
+	dwTime_t slotStart;
+	bool txLoaded;
+	// Slots that could not be programmed in time
+	uint32_t missedSlots;
+#ifdef DW_COMPACT_DEVICE
+	dwHandlers_t handlers;
+#endif
+} dwTdma_t;
+
+/**
+ * Initialize the scheduler of a device. The device must be configured, with
+ * permanent receive and auto acknowledge disabled.
+ */
+void dwTdmaInit(dwTdma_t *tdma, dwDevice_t *dev, const dwTdmaSuperframe_t *superframe,
+                dwTdmaPrepareTx_t prepareTx, dwTdmaReceived_t received);
+
+/**
+ * Starts the superframe with slot 0 at 'start' (device time, typically the
+ * system time plus a margin for the first programming).
+ */
+void dwTdmaStart(dwTdma_t *tdma, dwTime_t start);
+
+/**
+ * Stops the scheduler and puts the device in idle mode.
+ */
+void dwTdmaStop(dwTdma_t *tdma);
+
+/**
+ * Index of the next non idle slot after 'slot', and the number of slots from
+ * 'slot' to it. Returns the slot itself after a full superframe if it is the
+ * only active one.
+ */
+uint8_t dwTdmaNextSlot(const dwTdmaSuperframe_t *superframe, uint8_t slot,
+                       unsigned int *distance);
+
+/**
+ * Shortest slot for frames of 'length' bytes: air time of the frame, see
+ * dwGetFrameAirtime(), plus the receiver guard on both sides.
+ */
+dwTime_t dwTdmaMinimumSlotLength(dwDevice_t *dev, unsigned int length, dwTime_t guard);
+
+#endif //__LIBDW1000_TDMA_H__
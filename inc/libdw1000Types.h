@@ -43,51 +43,127 @@ typedef union dwTime_u {
 	} __attribute__((packed));
 } dwTime_t;
 
+/**
+ * Diagnostics of the last received frame. Filled by dwReadReceiveDiagnostics()
+ * so that derived values can be computed without further SPI accesses.
+ */
+typedef struct dwRxDiagnostics_s {
+	uint16_t stdNoise;
+	uint16_t fpAmpl1;
+	uint16_t fpAmpl2;
+	uint16_t fpAmpl3;
+	uint16_t cirPwr;
+	uint16_t rxPacc;
+	int32_t carrierIntegrator;
+	int32_t timeTrackingOffset;
+	uint32_t timeTrackingInterval;
+} dwRxDiagnostics_t;
+
+/**
+ * Cost of the delayed reply path measured by dwMeasureReplyDelay(), in device
+ * time units.
+ */
+typedef struct dwReplyDelay_s {
+	dwTime_t spiRoundTrip;
+	dwTime_t driverWork;
+	dwTime_t recommended;
+} dwReplyDelay_t;
+
 typedef void (*dwHandler_t)(struct dwDevice_s *dev);
 
+/**
+ * Software frame filter, called by dwHandleInterrupt() for each good frame
+ * before the received handler. Returns false to drop the frame, the receiver
+ * is then re-enabled and the received handler is not called.
+ */
+typedef bool (*dwFrameFilter_t)(struct dwDevice_s *dev);
+
+/**
+ * Callback handlers. Part of the device by default, with DW_COMPACT_DEVICE
+ * the device points to a table that can be shared by several devices.
+ */
+typedef struct dwHandlers_s {
+	dwHandler_t handleSent;
+	dwHandler_t handleError;
+	dwHandler_t handleReceived;
+	dwHandler_t handleReceiveTimeout;
+	dwHandler_t handleReceiveFailed;
+	dwHandler_t handleReceiveTimestampAvailable;
+	dwFrameFilter_t acceptFrame;
+} dwHandlers_t;
+
+/*
+ * Building with DW_COMPACT_DEVICE packs the flags and configuration fields of
+ * dwDevice_t in bitfields and shares the handlers, to reduce the footprint of
+ * systems with many radios.
+ */
+#ifdef DW_COMPACT_DEVICE
+#define DW_BITFIELD(type, name, bits) type name : bits
+#define DW_HANDLER(dev, name) ((dev)->handlers->name)
+#else
+#define DW_BITFIELD(type, name, bits) type name
+#define DW_HANDLER(dev, name) ((dev)->name)
+#endif
+
 /**
  * DW device type. Contains the context of a dw1000 device and should be passed
  * as first argument of most of the driver functions.
  */
 typedef struct dwDevice_s {
+#ifndef DW_STATIC_OPS
 	struct dwOps_s *ops;
+#endif
 	void *userdata;
 
 	/* State */
-	uint8_t sysctrl[LEN_SYS_CTRL];
-	uint8_t deviceMode;
+	// Registers accessed bit by bit are kept as native integers, in the
+	// little-endian byte order of the DW1000 (and of the supported MCUs)
+	uint64_t sysstatus;
+	uint32_t sysctrl;
+	uint32_t syscfg;
+	uint32_t sysmask;
 	uint8_t networkAndAddress[LEN_PANADR];
-	uint8_t syscfg[LEN_SYS_CFG];
-	uint8_t sysmask[LEN_SYS_MASK];
 	uint8_t chanctrl[LEN_CHAN_CTRL];
-	uint8_t sysstatus[LEN_SYS_STATUS];
 	uint8_t txfctrl[LEN_TX_FCTRL];
 
-	uint8_t extendedFrameLength;
 	uint8_t pacSize;
-	uint8_t pulseFrequency;
-	uint8_t dataRate;
-	uint8_t preambleLength;
-	uint8_t preambleCode;
-	uint8_t channel;
-	bool smartPower;
-	bool frameCheck;
-	bool permanentReceive;
-	bool wait4resp;
+	// Written from the interrupt handler, kept out of the bitfields so that
+	// they are updated with single byte stores. deviceMode is only changed
+	// with the device locked: IDLE_MODE to TX_MODE or RX_MODE by
+	// dwNewTransmit() and dwNewReceive(), TX_MODE to RX_MODE or IDLE_MODE by
+	// dwStartTransmit() and any mode to IDLE_MODE by dwIdle().
+	volatile uint8_t deviceMode;
+	volatile bool ackPending;
+	DW_BITFIELD(uint8_t, extendedFrameLength, 2);
+	DW_BITFIELD(uint8_t, pulseFrequency, 2);
+	DW_BITFIELD(uint8_t, dataRate, 2);
+	DW_BITFIELD(bool, wait4resp, 1);
+	DW_BITFIELD(bool, autoAck, 1);
+	DW_BITFIELD(uint8_t, preambleLength, 4);
+	DW_BITFIELD(uint8_t, channel, 3);
+	DW_BITFIELD(bool, forceTxPower, 1);
+	DW_BITFIELD(uint8_t, preambleCode, 5);
+	DW_BITFIELD(bool, smartPower, 1);
+	DW_BITFIELD(bool, frameCheck, 1);
+	DW_BITFIELD(bool, permanentReceive, 1);
 
 	dwTime_t antennaDelay;
 
 	// Callback handles
+#ifdef DW_COMPACT_DEVICE
+	dwHandlers_t *handlers;
+#else
 	dwHandler_t handleSent;
 	dwHandler_t handleError;
 	dwHandler_t handleReceived;
 	dwHandler_t handleReceiveTimeout;
 	dwHandler_t handleReceiveFailed;
 	dwHandler_t handleReceiveTimestampAvailable;
+	dwFrameFilter_t acceptFrame;
+#endif
 
 	// settings
 	uint32_t txPower;
-	bool forceTxPower;
 } dwDevice_t;
 
 typedef enum {dwSpiSpeedLow, dwSpiSpeedHigh} dwSpiSpeed_t;
@@ -130,6 +206,69 @@ typedef struct dwOps_s {
 	 * This function is optional, if not set softreset via SPI will be used.
 	 */
 	 void (*reset)(dwDevice_t *dev);
+
+	/**
+	 * Lock and unlock the access to the device. The driver locks the device
+	 * around register read-modify-write sequences and around the updates of
+	 * the device state, so that the API can be used from several tasks and
+	 * from the interrupt handler. Typically a recursive mutex when
+	 * dwHandleInterrupt() is called from a task, or masking of the DW1000
+	 * interrupt on bare metal systems. Needed when several devices share a
+	 * bus, see libdw1000Bus.h. Optional, the lock must be recursive.
+	 */
+	void (*lock)(dwDevice_t *dev);
+	void (*unlock)(dwDevice_t *dev);
+
+	/**
+	 * Waits at least 'delay' microseconds. Used by the polling engine, see
+	 * libdw1000Poll.h. Optional, if not set delayms is used with the delay
+	 * rounded up to the next millisecond.
+	 */
+	void (*delayus)(dwDevice_t* dev, unsigned int delay);
 } dwOps_t;
 
+#ifdef DW_STATIC_OPS
+/**
+ * Static dispatch of the DW operations, enabled by building with
+ * DW_STATIC_OPS. Instead of filling a dwOps_t the platform implements the
+ * functions below, they are then resolved at link time and can be inlined. The
+ * ops pointer passed to dwInit() is ignored and can be NULL. Meant for
+ * single-radio systems, multi-radio systems should use the default runtime
+ * dispatch.
+ */
+void dwOpsSpiRead(dwDevice_t* dev, const void *header, size_t headerLength,
+                                   void* data, size_t dataLength);
+void dwOpsSpiWrite(dwDevice_t* dev, const void *header, size_t headerLength,
+                                    const void* data, size_t dataLength);
+void dwOpsSpiSetSpeed(dwDevice_t* dev, dwSpiSpeed_t speed);
+void dwOpsDelayms(dwDevice_t* dev, unsigned int delay);
+// Optional, dwOpsDelayms is used if not implemented
+void dwOpsDelayus(dwDevice_t* dev, unsigned int delay) __attribute__((weak));
+// Optional, softreset via SPI is used if not implemented
+void dwOpsReset(dwDevice_t *dev) __attribute__((weak));
+// Optional
+void dwOpsLock(dwDevice_t *dev) __attribute__((weak));
+void dwOpsUnlock(dwDevice_t *dev) __attribute__((weak));
+
+#define DW_OPS_SPI_READ(dev, ...) dwOpsSpiRead(dev, __VA_ARGS__)
+#define DW_OPS_SPI_WRITE(dev, ...) dwOpsSpiWrite(dev, __VA_ARGS__)
+#define DW_OPS_SPI_SET_SPEED(dev, speed) dwOpsSpiSetSpeed(dev, speed)
+#define DW_OPS_DELAYMS(dev, delay) dwOpsDelayms(dev, delay)
+#define DW_OPS_DELAYUS(dev, delay) (dwOpsDelayus ? dwOpsDelayus(dev, delay) : dwOpsDelayms(dev, ((delay) + 999) / 1000))
+#define DW_OPS_HAS_RESET(dev) (dwOpsReset != 0)
+#define DW_OPS_RESET(dev) dwOpsReset(dev)
+#define DW_OPS_LOCK(dev) (dwOpsLock ? dwOpsLock(dev) : (void)0)
+#define DW_OPS_UNLOCK(dev) (dwOpsUnlock ? dwOpsUnlock(dev) : (void)0)
+#else
+#define DW_OPS_SPI_READ(dev, ...) (dev)->ops->spiRead(dev, __VA_ARGS__)
+#define DW_OPS_SPI_WRITE(dev, ...) (dev)->ops->spiWrite(dev, __VA_ARGS__)
+#define DW_OPS_SPI_SET_SPEED(dev, speed) (dev)->ops->spiSetSpeed(dev, speed)
+#define DW_OPS_DELAYMS(dev, delay) (dev)->ops->delayms(dev, delay)
+#define DW_OPS_DELAYUS(dev, delay) ((dev)->ops->delayus ? (dev)->ops->delayus(dev, delay) : (dev)->ops->delayms(dev, ((delay) + 999) / 1000))
+#define DW_OPS_HAS_RESET(dev) ((dev)->ops->reset != 0)
+#define DW_OPS_RESET(dev) (dev)->ops->reset(dev)
+#define DW_OPS_LOCK(dev) ((dev)->ops->lock ? (dev)->ops->lock(dev) : (void)0)
+#define DW_OPS_UNLOCK(dev) ((dev)->ops->unlock ? (dev)->ops->unlock(dev) : (void)0)
+#endif
+
 #endif //__LIBDW1000_TYPES_H__
@@ -18,10 +18,14 @@
  * limitations under the License.
  */
 
+#include <stddef.h>
 #include <string.h>
 #include <math.h>
 
 #include "libdw1000.h"
+#ifdef DW_STATIC_CONFIG
+#include "libdw1000StaticConfig.h"
+#endif
 
 
 static const uint8_t BIAS_500_16_ZERO = 10;
@@ -46,22 +50,86 @@ const uint8_t MODE_SHORTDATA_MID_ACCURACY[] = {TRX_RATE_850KBPS, TX_PULSE_FREQ_6
 const uint8_t MODE_LONGDATA_MID_ACCURACY[] = {TRX_RATE_850KBPS, TX_PULSE_FREQ_64MHZ, TX_PREAMBLE_LEN_1024};
 
 // Useful shortcuts
-#define delayms(delay) dev->ops->delayms(dev, delay)
+#define delayms(delay) DW_OPS_DELAYMS(dev, delay)
+
+// Precomputed SPI headers of the registers accessed for every frame
+static const dwSpiHeader_t SYS_STATUS_READ = DW_SPI_HEADER_READ(SYS_STATUS, NO_SUB);
+static const dwSpiHeader_t SYS_STATUS_WRITE = DW_SPI_HEADER_WRITE(SYS_STATUS, NO_SUB);
+static const dwSpiHeader_t SYS_STATUS_HIGH_READ = DW_SPI_HEADER_READ(SYS_STATUS, 3);
+static const dwSpiHeader_t SYS_STATUS_HIGH_WRITE = DW_SPI_HEADER_WRITE(SYS_STATUS, 3);
+static const dwSpiHeader_t SYS_CTRL_WRITE = DW_SPI_HEADER_WRITE(SYS_CTRL, NO_SUB);
+static const dwSpiHeader_t DX_TIME_WRITE = DW_SPI_HEADER_WRITE(DX_TIME, NO_SUB);
+static const dwSpiHeader_t TX_BUFFER_WRITE = DW_SPI_HEADER_WRITE(TX_BUFFER, NO_SUB);
+static const dwSpiHeader_t RX_BUFFER_READ = DW_SPI_HEADER_READ(RX_BUFFER, NO_SUB);
+static const dwSpiHeader_t RX_FINFO_READ = DW_SPI_HEADER_READ(RX_FINFO, NO_SUB);
+static const dwSpiHeader_t TX_STAMP_READ = DW_SPI_HEADER_READ(TX_TIME, TX_STAMP_SUB);
+static const dwSpiHeader_t RX_STAMP_READ = DW_SPI_HEADER_READ(RX_TIME, RX_STAMP_SUB);
+static const dwSpiHeader_t PMSC_CTRL0_READ = DW_SPI_HEADER_READ(PMSC, PMSC_CTRL0_SUB);
+static const dwSpiHeader_t PMSC_CTRL0_WRITE = DW_SPI_HEADER_WRITE(PMSC, PMSC_CTRL0_SUB);
 
 // Utility functions
 static void setBit(uint8_t data[], unsigned int n, unsigned int bit, bool val);
 static void writeValueToBytes(uint8_t data[], long val, unsigned int n);
-static bool getBit(uint8_t data[], unsigned int n, unsigned int bit);
+static inline void setBits(uint32_t* reg, uint32_t mask, bool val);
+static inline void setDeviceMode(dwDevice_t* dev, uint8_t mode);
+static uint32_t bytesToValue(const uint8_t data[], unsigned int n);
+static int32_t signExtend(uint32_t value, unsigned int bits);
 
 static void readBytesOTP(dwDevice_t* dev, uint16_t address, uint8_t data[]);
+static uint8_t crystalTrim(dwDevice_t* dev);
 
 static void dummy(){
 	;
 }
 
+#ifdef DW_COMPACT_DEVICE
+// Handlers of the devices that do not have their own table. Shared by all
+// these devices, so it is never modified, see DW_ATTACH()
+static dwHandlers_t defaultHandlers = {
+	.handleSent = dummy,
+	.handleError = dummy,
+	.handleReceived = dummy,
+	.handleReceiveTimeout = dummy,
+	.handleReceiveFailed = dummy,
+	.handleReceiveTimestampAvailable = dummy,
+};
+
+#define DW_ATTACH(dev, name, value) do { \
+		if((dev)->handlers != &defaultHandlers) { \
+			(dev)->handlers->name = (value); \
+		} \
+	} while(0)
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && UINTPTR_MAX == 0xFFFFFFFFu
+#define DW_CHECK_DEVICE_SIZE 64
+#endif
+#else
+#define DW_ATTACH(dev, name, value) ((dev)->name = (value))
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && UINTPTR_MAX == 0xFFFFFFFFu
+#define DW_CHECK_DEVICE_SIZE 96
+#endif
+#endif
+
+#ifdef DW_CHECK_DEVICE_SIZE
+// Footprint documented in the README, for 32 bits MCUs aligning uint64_t on
+// 8 bytes
+struct dwAlignment64_s {
+	uint8_t byte;
+	uint64_t value;
+};
+_Static_assert(offsetof(struct dwAlignment64_s, value) != 8 ||
+               sizeof(dwDevice_t) == DW_CHECK_DEVICE_SIZE,
+               "dwDevice_t size differs from the README");
+#endif
+
 void dwInit(dwDevice_t* dev, dwOps_t* ops)
 {
+#ifdef DW_STATIC_OPS
+	(void)ops;
+#else
 	dev->ops = ops;
+#endif
 	dev->userdata = NULL;
 
 	/* Device default state */
@@ -75,19 +143,26 @@ void dwInit(dwDevice_t* dev, dwOps_t* ops)
 	dev->smartPower = false;
 	dev->frameCheck = true;
 	dev->permanentReceive = false;
-	dev->deviceMode = IDLE_MODE;
+	dev->autoAck = false;
+	dev->ackPending = false;
+	setDeviceMode(dev, IDLE_MODE);
 
 	dev->forceTxPower = false;
 
 	writeValueToBytes(dev->antennaDelay.raw, 16384, LEN_STAMP);
 
 	// Dummy callback handlers
+#ifdef DW_COMPACT_DEVICE
+	dev->handlers = &defaultHandlers;
+#else
 	dev->handleSent = dummy;
 	dev->handleError = dummy;
 	dev->handleReceived = dummy;
 	dev->handleReceiveTimeout = dummy;
 	dev->handleReceiveFailed = dummy;
 	dev->handleReceiveTimestampAvailable = dummy;
+	dev->acceptFrame = NULL;
+#endif
 
 }
 
@@ -107,8 +182,8 @@ int dwConfigure(dwDevice_t* dev)
 	delayms(5);
 
 	// Reset the chip
-	if (dev->ops->reset) {
-		dev->ops->reset(dev);
+	if (DW_OPS_HAS_RESET(dev)) {
+		DW_OPS_RESET(dev);
 	} else {
 		dwSoftReset(dev);
 	}
@@ -122,7 +197,7 @@ int dwConfigure(dwDevice_t* dev)
 	dwSpiWrite(dev, PANADR, NO_SUB, dev->networkAndAddress, LEN_PANADR);
 
 	// default configuration
-	memset(dev->syscfg, 0, LEN_SYS_CFG);
+	dev->syscfg = 0;
 	dwSetDoubleBuffering(dev, false);
 	dwSetInterruptPolarity(dev, true);
 	dwWriteSystemConfigurationRegister(dev);
@@ -136,7 +211,7 @@ int dwConfigure(dwDevice_t* dev)
 	delayms(5);
 	dwEnableClock(dev, dwClockPll);
 	delayms(5);
-	//dev->ops->spiSetSpeed(dev, dwSpiSpeedHigh);
+	//DW_OPS_SPI_SET_SPEED(dev, dwSpiSpeedHigh);
 
 	// //Enable LED clock
 	// dwSpiWrite32(dev, PMSC, PMSC_CTRL0_SUB, dwSpiRead32(dev, PMSC, PMSC_CTRL0_SUB) | 0x008C0000);
@@ -167,6 +242,7 @@ void dwManageLDE(dwDevice_t* dev) {
 	uint8_t otpctrl[LEN_OTP_CTRL];
 	memset(pmscctrl0, 0, LEN_PMSC_CTRL0);
 	memset(otpctrl, 0, LEN_OTP_CTRL);
+	DW_OPS_LOCK(dev);
 	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
 	dwSpiRead(dev, OTP_IF, OTP_CTRL_SUB, otpctrl, LEN_OTP_CTRL);
 	pmscctrl0[0] = 0x01;
@@ -179,6 +255,7 @@ void dwManageLDE(dwDevice_t* dev) {
 	pmscctrl0[0] = 0x00;
 	pmscctrl0[1] = 0x02;
 	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	DW_OPS_UNLOCK(dev);
 }
 
 
@@ -191,6 +268,7 @@ void dwEnableAllLeds(dwDevice_t* dev)
 {
 	uint32_t reg;
 
+	DW_OPS_LOCK(dev);
 	// Set all 4 GPIO in LED mode
 	reg = dwSpiRead32(dev, GPIO_CTRL, GPIO_MODE_SUB);
 	reg &= ~0x00003FC0ul;
@@ -211,22 +289,24 @@ void dwEnableAllLeds(dwDevice_t* dev)
 	dwSpiWrite32(dev, PMSC, PMSC_LEDC, reg);
 	reg &= ~0x000f0000ul;
 	dwSpiWrite32(dev, PMSC, PMSC_LEDC, reg);
+	DW_OPS_UNLOCK(dev);
 }
 
 void dwEnableClock(dwDevice_t* dev, dwClock_t clock) {
 	uint8_t pmscctrl0[LEN_PMSC_CTRL0];
 	memset(pmscctrl0, 0, LEN_PMSC_CTRL0);
+	DW_OPS_LOCK(dev);
 	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
 	if(clock == dwClockAuto) {
-		dev->ops->spiSetSpeed(dev, dwSpiSpeedLow);
+		DW_OPS_SPI_SET_SPEED(dev, dwSpiSpeedLow);
 		pmscctrl0[0] = dwClockAuto;
 		pmscctrl0[1] &= 0xFE;
 	} else if(clock == dwClockXti) {
-		dev->ops->spiSetSpeed(dev, dwSpiSpeedLow);
+		DW_OPS_SPI_SET_SPEED(dev, dwSpiSpeedLow);
 		pmscctrl0[0] &= 0xFC;
 		pmscctrl0[0] |= dwClockXti;
 	} else if(clock == dwClockPll) {
-		dev->ops->spiSetSpeed(dev, dwSpiSpeedHigh);
+		DW_OPS_SPI_SET_SPEED(dev, dwSpiSpeedHigh);
 		pmscctrl0[0] &= 0xFC;
 		pmscctrl0[0] |= dwClockPll;
 	} else {
@@ -234,11 +314,48 @@ void dwEnableClock(dwDevice_t* dev, dwClock_t clock) {
 	}
 	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, 1);
 	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	DW_OPS_UNLOCK(dev);
+}
+
+void dwConfigureSleep(dwDevice_t* dev, bool loadLde)
+{
+	uint16_t wakeConfig = (1u << ONW_LDC_BIT) | (1u << ONW_LLDO_BIT) | (1u << PRES_SLEEP_BIT);
+	if(loadLde) {
+		wakeConfig |= 1u << ONW_LLDE_BIT;
+	}
+	dwSpiWrite(dev, AON, AON_WCFG_SUB, &wakeConfig, LEN_AON_WCFG);
+	// Only the low byte, the low power clock divider is kept
+	uint8_t cfg0 = (1u << SLEEP_EN_BIT) | (1u << WAKE_PIN_BIT) | (1u << WAKE_SPI_BIT);
+	dwSpiWrite(dev, AON, AON_CFG0_SUB, &cfg0, 1);
+	// Sleep counter disabled
+	uint8_t cfg1 = 0;
+	dwSpiWrite(dev, AON, AON_CFG1_SUB, &cfg1, 1);
+}
+
+void dwEnterSleepAfterTransmit(dwDevice_t* dev, bool val)
+{
+	DW_OPS_LOCK(dev);
+	uint32_t reg = dwSpiRead32(dev, PMSC, PMSC_CTRL1_SUB);
+	setBits(&reg, 1ul << ATXSLP_BIT, val);
+	setBits(&reg, 1ul << ARXSLP_BIT, false);
+	dwSpiWrite32(dev, PMSC, PMSC_CTRL1_SUB, reg);
+	DW_OPS_UNLOCK(dev);
+}
+
+void dwEnterSleep(dwDevice_t* dev)
+{
+	DW_OPS_LOCK(dev);
+	dwIdle(dev);
+	// Upload the configuration to the always-on memory, which enters sleep
+	dwSpiWrite8(dev, AON, AON_CTRL_SUB, 0x00);
+	dwSpiWrite8(dev, AON, AON_CTRL_SUB, 1u << SAVE_BIT);
+	DW_OPS_UNLOCK(dev);
 }
 
 void dwSoftReset(dwDevice_t* dev)
 {
 	uint8_t pmscctrl0[LEN_PMSC_CTRL0];
+	DW_OPS_LOCK(dev);
 	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
 	pmscctrl0[0] = 0x01;
 	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
@@ -250,6 +367,7 @@ void dwSoftReset(dwDevice_t* dev)
 	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
 	// force into idle mode
 	dwIdle(dev);
+	DW_OPS_UNLOCK(dev);
 }
 
 /**
@@ -258,12 +376,14 @@ void dwSoftReset(dwDevice_t* dev)
  */
 void dwRxSoftReset(dwDevice_t* dev) {
 	uint8_t pmscctrl0[LEN_PMSC_CTRL0];
-	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	DW_OPS_LOCK(dev);
+	dwSpiReadHeader(dev, &PMSC_CTRL0_READ, pmscctrl0, LEN_PMSC_CTRL0);
 
 	pmscctrl0[3] = pmscctrl0[3] & 0xEF;
-	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	dwSpiWriteHeader(dev, &PMSC_CTRL0_WRITE, pmscctrl0, LEN_PMSC_CTRL0);
 	pmscctrl0[3] = pmscctrl0[3] | 0x10;
-	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	dwSpiWriteHeader(dev, &PMSC_CTRL0_WRITE, pmscctrl0, LEN_PMSC_CTRL0);
+	DW_OPS_UNLOCK(dev);
 }
 
 /* ###########################################################################
@@ -271,15 +391,17 @@ void dwRxSoftReset(dwDevice_t* dev) {
  * ######################################################################### */
 
 void dwReadSystemConfigurationRegister(dwDevice_t* dev) {
-	dwSpiRead(dev, SYS_CFG, NO_SUB, dev->syscfg, LEN_SYS_CFG);
+	dwSpiRead(dev, SYS_CFG, NO_SUB, &dev->syscfg, LEN_SYS_CFG);
 }
 
 void dwWriteSystemConfigurationRegister(dwDevice_t* dev) {
-	dwSpiWrite(dev, SYS_CFG, NO_SUB, dev->syscfg, LEN_SYS_CFG);
+	dwSpiWrite(dev, SYS_CFG, NO_SUB, &dev->syscfg, LEN_SYS_CFG);
 }
 
 void dwReadSystemEventStatusRegister(dwDevice_t* dev) {
-	dwSpiRead(dev, SYS_STATUS, NO_SUB, dev->sysstatus, LEN_SYS_STATUS);
+	uint64_t sysstatus = 0;
+	dwSpiReadHeader(dev, &SYS_STATUS_READ, &sysstatus, LEN_SYS_STATUS);
+	dev->sysstatus = sysstatus;
 }
 
 void dwReadNetworkIdAndDeviceAddress(dwDevice_t* dev) {
@@ -291,11 +413,11 @@ void dwWriteNetworkIdAndDeviceAddress(dwDevice_t* dev) {
 }
 
 void dwReadSystemEventMaskRegister(dwDevice_t* dev) {
-	dwSpiRead(dev, SYS_MASK, NO_SUB, dev->sysmask, LEN_SYS_MASK);
+	dwSpiRead(dev, SYS_MASK, NO_SUB, &dev->sysmask, LEN_SYS_MASK);
 }
 
 void dwWriteSystemEventMaskRegister(dwDevice_t* dev) {
-	dwSpiWrite(dev, SYS_MASK, NO_SUB, dev->sysmask, LEN_SYS_MASK);
+	dwSpiWrite(dev, SYS_MASK, NO_SUB, &dev->sysmask, LEN_SYS_MASK);
 }
 
 void dwReadChannelControlRegister(dwDevice_t* dev) {
@@ -318,126 +440,217 @@ void dwWriteTransmitFrameControlRegister(dwDevice_t* dev) {
 
 void dwSetReceiveWaitTimeout(dwDevice_t *dev, uint16_t timeout) {
 	dwSpiWrite(dev, RX_FWTO, NO_SUB, &timeout, 2);
-	setBit(dev->syscfg, LEN_SYS_CFG, RXWTOE_BIT, timeout!=0);
+	setBits(&dev->syscfg, 1ul << RXWTOE_BIT, timeout!=0);
+}
+
+void dwSetWaitForResponseDelay(dwDevice_t *dev, uint32_t delay) {
+	uint8_t w4rTim[LEN_W4R_TIM];
+	writeValueToBytes(w4rTim, delay & 0x000FFFFFul, LEN_W4R_TIM);
+	dwSpiWrite(dev, ACK_RESP_T, W4R_TIM_SUB, w4rTim, LEN_W4R_TIM);
+}
+
+void dwSetPreambleDetectionTimeout(dwDevice_t *dev, uint16_t timeout) {
+	dwSpiWrite(dev, DRX_TUNE, DRX_PRETOC_SUB, &timeout, LEN_DRX_PRETOC);
+}
+
+void dwSetPanId(dwDevice_t* dev, uint16_t panId) {
+	dev->networkAndAddress[2] = panId & 0xFF;
+	dev->networkAndAddress[3] = (panId >> 8) & 0xFF;
+}
+
+void dwSetShortAddress(dwDevice_t* dev, uint16_t address) {
+	dev->networkAndAddress[0] = address & 0xFF;
+	dev->networkAndAddress[1] = (address >> 8) & 0xFF;
+}
+
+void dwSetAutoAcknowledge(dwDevice_t* dev, bool val) {
+	dev->autoAck = val;
+	setBits(&dev->syscfg, 1ul << AUTOACK_BIT, val);
+	if(val) {
+		// the chip only acknowledges frames accepted by the frame filter
+		dwSetFrameFilter(dev, true);
+	}
+}
+
+void dwSetAutoAcknowledgeTurnaround(dwDevice_t* dev, uint8_t symbols) {
+	dwSpiWrite8(dev, ACK_RESP_T, ACK_TIM_SUB, symbols);
 }
 
 void dwSetFrameFilter(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFEN_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFEN_BIT, val);
 }
 
 void dwSetFrameFilterBehaveCoordinator(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFBC_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFBC_BIT, val);
 }
 
 void dwSetFrameFilterAllowBeacon(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFAB_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFAB_BIT, val);
 }
 
 void dwSetFrameFilterAllowData(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFAD_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFAD_BIT, val);
 }
 
 void dwSetFrameFilterAllowAcknowledgement(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFAA_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFAA_BIT, val);
 }
 
 void dwSetFrameFilterAllowMAC(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFAM_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFAM_BIT, val);
 }
 
 void dwSetFrameFilterAllowReserved(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, FFAR_BIT, val);
+	setBits(&dev->syscfg, 1ul << FFAR_BIT, val);
 }
 
 void dwSetDoubleBuffering(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, DIS_DRXB_BIT, !val);
+	setBits(&dev->syscfg, 1ul << DIS_DRXB_BIT, !val);
 }
 
 void dwSetInterruptPolarity(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, HIRQ_POL_BIT, val);
+	setBits(&dev->syscfg, 1ul << HIRQ_POL_BIT, val);
 }
 
 void dwSetReceiverAutoReenable(dwDevice_t* dev, bool val) {
-	setBit(dev->syscfg, LEN_SYS_CFG, RXAUTR_BIT, val);
+	setBits(&dev->syscfg, 1ul << RXAUTR_BIT, val);
 }
 
 void dwInterruptOnSent(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_MASK, TXFRS_BIT, val);
+	setBits(&dev->sysmask, 1ul << TXFRS_BIT, val);
 }
 
 void dwInterruptOnReceived(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_MASK, RXDFR_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_MASK, RXFCG_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXDFR_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXFCG_BIT, val);
 }
 
 void dwInterruptOnReceiveFailed(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_STATUS, LDEERR_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_STATUS, RXFCE_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_STATUS, RXPHE_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_STATUS, RXRFSL_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_MASK, RXSFDTO_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_MASK, AFFREJ_BIT, val);
+	setBits(&dev->sysmask, 1ul << LDEERR_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXFCE_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXPHE_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXRFSL_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXSFDTO_BIT, val);
+	setBits(&dev->sysmask, 1ul << AFFREJ_BIT, val);
 }
 
 void dwInterruptOnReceiveTimeout(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_MASK, RXRFTO_BIT, val);
-	setBit(dev->sysmask, LEN_SYS_MASK, RXPTO_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXRFTO_BIT, val);
+	setBits(&dev->sysmask, 1ul << RXPTO_BIT, val);
 }
 
 void dwInterruptOnReceiveTimestampAvailable(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_MASK, LDEDONE_BIT, val);
+	setBits(&dev->sysmask, 1ul << LDEDONE_BIT, val);
 }
 
 void dwInterruptOnAutomaticAcknowledgeTrigger(dwDevice_t* dev, bool val) {
-	setBit(dev->sysmask, LEN_SYS_MASK, AAT_BIT, val);
+	setBits(&dev->sysmask, 1ul << AAT_BIT, val);
 }
 
 void dwClearInterrupts(dwDevice_t* dev) {
-	memset(dev->sysmask, 0, LEN_SYS_MASK);
+	dev->sysmask = 0;
+}
+
+void dwLock(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
+}
+
+void dwUnlock(dwDevice_t* dev) {
+	DW_OPS_UNLOCK(dev);
+}
+
+// Single byte store, the device must be locked
+static inline void setDeviceMode(dwDevice_t* dev, uint8_t mode) {
+	dev->deviceMode = mode;
 }
 
 void dwIdle(dwDevice_t* dev)
 {
-	 memset(dev->sysctrl, 0, LEN_SYS_CTRL);
-	 dev->sysctrl[0] |= 1<<TRXOFF_BIT;
-	 dev->deviceMode = IDLE_MODE;
-	 dwSpiWrite(dev, SYS_CTRL, NO_SUB, dev->sysctrl, LEN_SYS_CTRL);
+	 DW_OPS_LOCK(dev);
+	 dev->sysctrl = 1ul << TRXOFF_BIT;
+	 setDeviceMode(dev, IDLE_MODE);
+	 // an automatic acknowledgement in progress is aborted as well
+	 dev->ackPending = false;
+	 dwSpiWriteHeader(dev, &SYS_CTRL_WRITE, &dev->sysctrl, LEN_SYS_CTRL);
+	 DW_OPS_UNLOCK(dev);
 }
 
 void dwNewReceive(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
 	dwIdle(dev);
-	memset(dev->sysctrl, 0, LEN_SYS_CTRL);
+	dev->sysctrl = 0;
 	dwClearReceiveStatus(dev);
-	dev->deviceMode = RX_MODE;
+	setDeviceMode(dev, RX_MODE);
+	DW_OPS_UNLOCK(dev);
+}
+
+// The chip flags a delayed send or receiver turn-on that is already in the
+// past (it would otherwise happen one counter period, ~17s, later). The
+// operation is then aborted, the device must be locked.
+static bool abortLateSchedule(dwDevice_t* dev, bool transmit) {
+	uint8_t status[2];
+	dwSpiReadHeader(dev, &SYS_STATUS_HIGH_READ, status, sizeof(status));
+	status[0] &= 1 << (HPDWARN_BIT - 24);
+	status[1] &= transmit ? 1 << (TXPUTE_BIT - 32) : 0;
+	if(status[0] || status[1]) {
+		dwIdle(dev);
+		dwSpiWriteHeader(dev, &SYS_STATUS_HIGH_WRITE, status, sizeof(status));
+		return true;
+	}
+	return false;
+}
+
+int dwStartReceive(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
+	setBits(&dev->sysctrl, 1ul << SFCST_BIT, !dev->frameCheck);
+	setBits(&dev->sysctrl, 1ul << RXENAB_BIT, true);
+	dwSpiWriteHeader(dev, &SYS_CTRL_WRITE, &dev->sysctrl, LEN_SYS_CTRL);
+	if((dev->sysctrl & (1ul << RXDLYS_BIT)) && abortLateSchedule(dev, false)) {
+		DW_OPS_UNLOCK(dev);
+		return DW_ERROR_LATE_SCHEDULE;
+	}
+	DW_OPS_UNLOCK(dev);
+	return DW_ERROR_OK;
 }
 
-void dwStartReceive(dwDevice_t* dev) {
-	setBit(dev->sysctrl, LEN_SYS_CTRL, SFCST_BIT, !dev->frameCheck);
-	setBit(dev->sysctrl, LEN_SYS_CTRL, RXENAB_BIT, true);
-	dwSpiWrite(dev, SYS_CTRL, NO_SUB, dev->sysctrl, LEN_SYS_CTRL);
+// Re-enables the receiver in one locked sequence
+static void restartReceive(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
+	dwNewReceive(dev);
+	dwStartReceive(dev);
+	DW_OPS_UNLOCK(dev);
 }
 
 void dwNewTransmit(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
 	dwIdle(dev);
-	memset(dev->sysctrl, 0, LEN_SYS_CTRL);
+	dev->sysctrl = 0;
 	dwClearTransmitStatus(dev);
-	dev->deviceMode = TX_MODE;
+	setDeviceMode(dev, TX_MODE);
+	DW_OPS_UNLOCK(dev);
 }
 
-void dwStartTransmit(dwDevice_t* dev) {
+int dwStartTransmit(dwDevice_t* dev) {
+	DW_OPS_LOCK(dev);
 	dwWriteTransmitFrameControlRegister(dev);
-	setBit(dev->sysctrl, LEN_SYS_CTRL, SFCST_BIT, !dev->frameCheck);
-	setBit(dev->sysctrl, LEN_SYS_CTRL, TXSTRT_BIT, true);
-	dwSpiWrite(dev, SYS_CTRL, NO_SUB, dev->sysctrl, LEN_SYS_CTRL);
+	setBits(&dev->sysctrl, 1ul << SFCST_BIT, !dev->frameCheck);
+	setBits(&dev->sysctrl, 1ul << TXSTRT_BIT, true);
+	dwSpiWriteHeader(dev, &SYS_CTRL_WRITE, &dev->sysctrl, LEN_SYS_CTRL);
+	if((dev->sysctrl & (1ul << TXDLYS_BIT)) && abortLateSchedule(dev, true)) {
+		DW_OPS_UNLOCK(dev);
+		return DW_ERROR_LATE_SCHEDULE;
+	}
 	if(dev->permanentReceive) {
-		memset(dev->sysctrl, 0, LEN_SYS_CTRL);
-		dev->deviceMode = RX_MODE;
+		dev->sysctrl = 0;
+		setDeviceMode(dev, RX_MODE);
 		dwStartReceive(dev);
 	} else if (dev->wait4resp) {
-		dev->deviceMode = RX_MODE;
+		setDeviceMode(dev, RX_MODE);
 	} else {
-		dev->deviceMode = IDLE_MODE;
+		setDeviceMode(dev, IDLE_MODE);
 	}
+	DW_OPS_UNLOCK(dev);
+	return DW_ERROR_OK;
 }
 
 void dwNewConfiguration(dwDevice_t* dev) {
@@ -470,8 +683,10 @@ void dwCommitConfiguration(dwDevice_t* dev) {
 }
 
 void dwWaitForResponse(dwDevice_t* dev, bool val) {
+	DW_OPS_LOCK(dev);
 	dev->wait4resp = val;
-	setBit(dev->sysctrl, LEN_SYS_CTRL, WAIT4RESP_BIT, val);
+	setBits(&dev->sysctrl, 1ul << WAIT4RESP_BIT, val);
+	DW_OPS_UNLOCK(dev);
 }
 
 void dwSuppressFrameCheck(dwDevice_t* dev, bool val) {
@@ -480,48 +695,197 @@ void dwSuppressFrameCheck(dwDevice_t* dev, bool val) {
 
 void dwUseSmartPower(dwDevice_t* dev, bool smartPower) {
 	dev->smartPower = smartPower;
-	setBit(dev->syscfg, LEN_SYS_CFG, DIS_STXP_BIT, !smartPower);
+	setBits(&dev->syscfg, 1ul << DIS_STXP_BIT, !smartPower);
 }
 
-dwTime_t dwSetDelay(dwDevice_t* dev, const dwTime_t* delay) {
+static bool armDelayedTxRx(dwDevice_t* dev) {
 	if(dev->deviceMode == TX_MODE) {
-		setBit(dev->sysctrl, LEN_SYS_CTRL, TXDLYS_BIT, true);
+		setBits(&dev->sysctrl, 1ul << TXDLYS_BIT, true);
 	} else if(dev->deviceMode == RX_MODE) {
-		setBit(dev->sysctrl, LEN_SYS_CTRL, RXDLYS_BIT, true);
+		setBits(&dev->sysctrl, 1ul << RXDLYS_BIT, true);
 	} else {
 		// in idle, ignore
+		return false;
+	}
+	return true;
+}
+
+// Duration of one preamble symbol in device time units (993.59ns at 16MHz PRF
+// and 1017.63ns at 64MHz PRF)
+#define PREAMBLE_SYMBOL_16MHZ 63488
+#define PREAMBLE_SYMBOL_64MHZ 65024
+
+// Preamble length in symbols, indexed by TX_PREAMBLE_LEN_*
+static const uint16_t PREAMBLE_SYMBOLS[16] = {
+	[TX_PREAMBLE_LEN_64] = 64,
+	[TX_PREAMBLE_LEN_128] = 128,
+	[TX_PREAMBLE_LEN_256] = 256,
+	[TX_PREAMBLE_LEN_512] = 512,
+	[TX_PREAMBLE_LEN_1024] = 1024,
+	[TX_PREAMBLE_LEN_1536] = 1536,
+	[TX_PREAMBLE_LEN_2048] = 2048,
+	[TX_PREAMBLE_LEN_4096] = 4096,
+};
+
+// SFD length (as set by dwSetDataRate()) and bit durations in device time
+// units, indexed by TRX_RATE_*. The PHR is sent at 850kbps, or 110kbps in
+// 110kbps mode.
+static const struct {
+	uint8_t sfdSymbols;
+	uint32_t phrBit;
+	uint32_t dataBit;
+} RATE_TIMING[4] = {
+	[TRX_RATE_110KBPS] = {64, 524288, 524288},
+	[TRX_RATE_850KBPS] = {16, 65536, 65536},
+	[TRX_RATE_6800KBPS] = {8, 65536, 8192},
+	[3] = {64, 524288, 524288},
+};
+
+#define PHR_BITS 21
+
+// Duration of the preamble and SFD in device time units
+static uint64_t preambleDuration(dwDevice_t* dev) {
+	uint32_t symbols = PREAMBLE_SYMBOLS[dev->preambleLength & 0x0F] +
+	                   RATE_TIMING[dev->dataRate & 0x03].sfdSymbols;
+	if(dev->pulseFrequency == TX_PULSE_FREQ_16MHZ) {
+		return (uint64_t)symbols * PREAMBLE_SYMBOL_16MHZ;
+	}
+	return (uint64_t)symbols * PREAMBLE_SYMBOL_64MHZ;
+}
+
+// Reed-Solomon adds 48 parity bits to each block of up to 330 data bits. The
+// division by 330 is done with a multiplication, exact up to 1023 bytes.
+#define RS_PARITY_BITS 48
+#define RS_BLOCKS(bits) ((((bits) + 329) * 12711ul) >> 22)
+
+dwTime_t dwGetPreambleDuration(dwDevice_t* dev) {
+	dwTime_t duration;
+	duration.full = preambleDuration(dev);
+	return duration;
+}
+
+dwTime_t dwGetFrameAirtime(dwDevice_t* dev, unsigned int length) {
+	uint32_t bits = (length & 0x3FF) * 8;
+	bits += RS_PARITY_BITS * RS_BLOCKS(bits);
+
+	dwTime_t airtime;
+	airtime.full = preambleDuration(dev) +
+	               PHR_BITS * RATE_TIMING[dev->dataRate & 0x03].phrBit +
+	               (uint64_t)bits * RATE_TIMING[dev->dataRate & 0x03].dataBit;
+	return airtime;
+}
+
+unsigned int dwGetFrameAirtimeUs(dwDevice_t* dev, unsigned int length) {
+	// One microsecond is 63897.6 device time units
+	return (unsigned int)((dwGetFrameAirtime(dev, length).full * 10 + 638975) / 638976);
+}
+
+static dwTime_t writeDelayedTime(dwDevice_t* dev, dwTime_t futureTime) {
+	// the low 9 bits are ignored by the chip
+	futureTime.raw[0] = 0;
+	futureTime.raw[1] &= 0xFE;
+	dwSpiWriteHeader(dev, &DX_TIME_WRITE, futureTime.raw, LEN_DX_TIME);
+	return futureTime;
+}
+
+dwTime_t dwSetDelay(dwDevice_t* dev, const dwTime_t* delay) {
+	DW_OPS_LOCK(dev);
+	if(!armDelayedTxRx(dev)) {
+		DW_OPS_UNLOCK(dev);
 		dwTime_t zero = {.full = 0};
 		return zero;
 	}
-	uint8_t delayBytes[5];
 	dwTime_t futureTime;
 	dwGetSystemTimestamp(dev, &futureTime);
 	futureTime.full += delay->full;
-	memcpy(delayBytes, futureTime.raw, sizeof(futureTime.raw));
-	delayBytes[0] = 0;
-	delayBytes[1] &= 0xFE;
-	dwSpiWrite(dev, DX_TIME, NO_SUB, delayBytes, LEN_DX_TIME);
+	futureTime = writeDelayedTime(dev, futureTime);
+	DW_OPS_UNLOCK(dev);
 	// adjust expected time with configured antenna delay
-	memcpy(futureTime.raw, delayBytes, sizeof(futureTime.raw));
 	futureTime.full += dev->antennaDelay.full;
 	return futureTime;
 }
 
+dwTime_t dwSetDelayFrom(dwDevice_t* dev, const dwTime_t* reference, const dwTime_t* delay) {
+	dwTime_t futureTime = {.full = 0};
+	DW_OPS_LOCK(dev);
+	if(!armDelayedTxRx(dev)) {
+		DW_OPS_UNLOCK(dev);
+		return futureTime;
+	}
+	futureTime.full = ((reference->full & TIME_MASK) + delay->full) & TIME_MASK;
+	futureTime = writeDelayedTime(dev, futureTime);
+	DW_OPS_UNLOCK(dev);
+	// adjust expected time with configured antenna delay
+	futureTime.full = (futureTime.full + dev->antennaDelay.full) & TIME_MASK;
+	return futureTime;
+}
+
 void dwSetTxRxTime(dwDevice_t* dev, const dwTime_t futureTime) {
-	if(dev->deviceMode == TX_MODE) {
-		setBit(dev->sysctrl, LEN_SYS_CTRL, TXDLYS_BIT, true);
-	} else if(dev->deviceMode == RX_MODE) {
-		setBit(dev->sysctrl, LEN_SYS_CTRL, RXDLYS_BIT, true);
-	} else {
-		return;
+	DW_OPS_LOCK(dev);
+	if(armDelayedTxRx(dev)) {
+		writeDelayedTime(dev, futureTime);
 	}
-	uint8_t delayBytes[5];
-	memcpy(delayBytes, futureTime.raw, sizeof(futureTime.raw));
-	delayBytes[0] = 0;
-	delayBytes[1] &= 0xFE;
-	dwSpiWrite(dev, DX_TIME, NO_SUB, delayBytes, LEN_DX_TIME);
+	DW_OPS_UNLOCK(dev);
+}
+
+static uint64_t timeSince(const dwTime_t* start, const dwTime_t* end) {
+	return (end->full - start->full) & TIME_MASK;
 }
 
+void dwMeasureReplyDelay(dwDevice_t* dev, unsigned int length,
+                         dwTime_t interruptLatency, unsigned int iterations,
+                         dwReplyDelay_t* result) {
+	uint8_t payload[LEN_UWB_FRAMES] = {0};
+	uint8_t txfctrl[LEN_TX_FCTRL];
+	uint8_t noStatus[LEN_SYS_STATUS] = {0};
+	uint8_t noCtrl[LEN_SYS_CTRL] = {0};
+	dwTime_t t0, t1, t2, rxTime;
+	uint64_t sysstatus = dev->sysstatus;
+
+	if(length > LEN_UWB_FRAMES - 2) {
+		length = LEN_UWB_FRAMES - 2;
+	}
+	memcpy(txfctrl, dev->txfctrl, LEN_TX_FCTRL);
+
+	result->spiRoundTrip.full = 0;
+	result->driverWork.full = 0;
+	while(iterations--) {
+		t0.full = 0;
+		t1.full = 0;
+		t2.full = 0;
+		dwGetSystemTimestamp(dev, &t0);
+		dwGetSystemTimestamp(dev, &t1);
+
+		// Same SPI traffic as an interrupt followed by a delayed reply. Writing
+		// zeros to SYS_STATUS and SYS_CTRL has no effect on the chip.
+		dwReadSystemEventStatusRegister(dev);
+		dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, noStatus, LEN_SYS_STATUS);
+		dwGetReceiveTimestamp(dev, &rxTime);
+		dwSetData(dev, payload, length);
+		writeDelayedTime(dev, t1);
+		dwWriteTransmitFrameControlRegister(dev);
+		dwSpiWriteHeader(dev, &SYS_CTRL_WRITE, noCtrl, LEN_SYS_CTRL);
+
+		dwGetSystemTimestamp(dev, &t2);
+
+		uint64_t spiRoundTrip = timeSince(&t0, &t1);
+		uint64_t driverWork = timeSince(&t1, &t2);
+		if(spiRoundTrip > result->spiRoundTrip.full) {
+			result->spiRoundTrip.full = spiRoundTrip;
+		}
+		if(driverWork > result->driverWork.full) {
+			result->driverWork.full = driverWork;
+		}
+	}
+	memcpy(dev->txfctrl, txfctrl, LEN_TX_FCTRL);
+	dev->sysstatus = sysstatus;
+
+	// The delayed TX time is the RMARKER, preamble and SFD are sent before it
+	uint64_t recommended = interruptLatency.full + result->spiRoundTrip.full +
+		result->driverWork.full;
+	recommended += recommended / 4;  // 25% margin for jitter
+	result->recommended.full = recommended + preambleDuration(dev);
+}
 
 void dwSetDataRate(dwDevice_t* dev, uint8_t rate) {
 	rate &= 0x03;
@@ -529,9 +893,9 @@ void dwSetDataRate(dwDevice_t* dev, uint8_t rate) {
 	dev->txfctrl[1] |= (uint8_t)((rate << 5) & 0xFF);
 	// special 110kbps flag
 	if(rate == TRX_RATE_110KBPS) {
-		setBit(dev->syscfg, LEN_SYS_CFG, RXM110K_BIT, true);
+		setBits(&dev->syscfg, 1ul << RXM110K_BIT, true);
 	} else {
-		setBit(dev->syscfg, LEN_SYS_CFG, RXM110K_BIT, false);
+		setBits(&dev->syscfg, 1ul << RXM110K_BIT, false);
 	}
 	// SFD mode and type (non-configurable, as in Table )
 	if(rate == TRX_RATE_6800KBPS) {
@@ -588,8 +952,8 @@ void dwSetPreambleLength(dwDevice_t* dev, uint8_t prealen) {
 
 void dwUseExtendedFrameLength(dwDevice_t* dev, bool val) {
 	dev->extendedFrameLength = (val ? FRAME_LENGTH_EXTENDED : FRAME_LENGTH_NORMAL);
-	dev->syscfg[2] &= 0xFC;
-	dev->syscfg[2] |= dev->extendedFrameLength;
+	dev->syscfg &= ~(0x03ul << PHR_MODE_SUB);
+	dev->syscfg |= (uint32_t)dev->extendedFrameLength << PHR_MODE_SUB;
 }
 
 void dwReceivePermanently(dwDevice_t* dev, bool val) {
@@ -626,6 +990,7 @@ void dwSetDefaults(dwDevice_t* dev) {
 		dwSetFrameFilterAllowData(dev, false);
 		//for reserved (blink) frame filtering
 		dwSetFrameFilterAllowReserved(dev, false);
+		dwSetAutoAcknowledge(dev, false);
 		//setFrameFilterAllowMAC(true);
 		//setFrameFilterAllowBeacon(true);
 		//setFrameFilterAllowAcknowledgement(true);
@@ -653,10 +1018,12 @@ void dwSetData(dwDevice_t* dev, uint8_t data[], unsigned int n) {
 		return; // TODO proper error handling: frame/buffer size
 	}
 	// transmit data and length
-	dwSpiWrite(dev, TX_BUFFER, NO_SUB, data, n);
+	DW_OPS_LOCK(dev);
+	dwSpiWriteHeader(dev, &TX_BUFFER_WRITE, data, n);
 	dev->txfctrl[0] = (uint8_t)(n & 0xFF); // 1 byte (regular length + 1 bit)
 	dev->txfctrl[1] &= 0xE0;
 	dev->txfctrl[1] |= (uint8_t)((n >> 8) & 0x03);	// 2 added bits if extended length
+	DW_OPS_UNLOCK(dev);
 }
 
 unsigned int dwGetDataLength(dwDevice_t* dev) {
@@ -667,7 +1034,7 @@ unsigned int dwGetDataLength(dwDevice_t* dev) {
 	} else if(dev->deviceMode == RX_MODE) {
 		// 10 bits of RX frame control register
 		uint8_t rxFrameInfo[LEN_RX_FINFO];
-		dwSpiRead(dev, RX_FINFO, NO_SUB, rxFrameInfo, LEN_RX_FINFO);
+		dwSpiReadHeader(dev, &RX_FINFO_READ, rxFrameInfo, LEN_RX_FINFO);
 		len = ((((unsigned int)rxFrameInfo[1] << 8) | (unsigned int)rxFrameInfo[0]) & 0x03FF);
 	}
 	if(dev->frameCheck && len > 2) {
@@ -680,23 +1047,23 @@ void dwGetData(dwDevice_t* dev, uint8_t data[], unsigned int n) {
 	if(n <= 0) {
 		return;
 	}
-	dwSpiRead(dev, RX_BUFFER, NO_SUB, data, n);
+	dwSpiReadHeader(dev, &RX_BUFFER_READ, data, n);
 }
 
 void dwGetTransmitTimestamp(dwDevice_t* dev, dwTime_t* time) {
-	dwSpiRead(dev, TX_TIME, TX_STAMP_SUB, time->raw, LEN_TX_STAMP);
+	dwSpiReadHeader(dev, &TX_STAMP_READ, time->raw, LEN_TX_STAMP);
 }
 
 void dwGetReceiveTimestamp(dwDevice_t* dev, dwTime_t* time) {
 	time->full = 0;
-	dwSpiRead(dev, RX_TIME, RX_STAMP_SUB, time->raw, LEN_RX_STAMP);
+	dwSpiReadHeader(dev, &RX_STAMP_READ, time->raw, LEN_RX_STAMP);
 	// correct timestamp (i.e. consider range bias)
 	dwCorrectTimestamp(dev, time);
 }
 
 void dwGetRawReceiveTimestamp(dwDevice_t* dev, dwTime_t* time) {
 	time->full = 0;
-	dwSpiRead(dev, RX_TIME, RX_STAMP_SUB, time->raw, LEN_RX_STAMP);
+	dwSpiReadHeader(dev, &RX_STAMP_READ, time->raw, LEN_RX_STAMP);
 }
 
 void dwCorrectTimestamp(dwDevice_t* dev, dwTime_t* timestamp) {
@@ -757,70 +1124,27 @@ void dwGetSystemTimestamp(dwDevice_t* dev, dwTime_t* time) {
 	dwSpiRead(dev, SYS_TIME, NO_SUB, time->raw, LEN_SYS_TIME);
 }
 
-bool dwIsTransmitDone(dwDevice_t* dev) {
-	return getBit(dev->sysstatus, LEN_SYS_STATUS, TXFRS_BIT);
-}
-
-bool dwIsReceiveTimestampAvailable(dwDevice_t* dev) {
-	return getBit(dev->sysstatus, LEN_SYS_STATUS, LDEDONE_BIT);
-}
-
-bool dwIsReceiveDone(dwDevice_t* dev) {
-	if(dev->frameCheck) {
-		return getBit(dev->sysstatus, LEN_SYS_STATUS, RXFCG_BIT);
-	}
-	return getBit(dev->sysstatus, LEN_SYS_STATUS, RXDFR_BIT);
-}
-
-bool dwIsReceiveFailed(dwDevice_t *dev) {
-	bool ldeErr = getBit(dev->sysstatus, LEN_SYS_STATUS, LDEERR_BIT);
-	bool rxCRCErr = getBit(dev->sysstatus, LEN_SYS_STATUS, RXFCE_BIT);
-	bool rxHeaderErr = getBit(dev->sysstatus, LEN_SYS_STATUS, RXPHE_BIT);
-	bool rxDecodeErr = getBit(dev->sysstatus, LEN_SYS_STATUS, RXRFSL_BIT);
-
-
-	bool rxSfdto = getBit(dev->sysstatus, LEN_SYS_STATUS, RXSFDTO_BIT);
-	bool affrej = getBit(dev->sysstatus, LEN_SYS_STATUS, AFFREJ_BIT);
-
-	return (ldeErr || rxCRCErr || rxHeaderErr || rxDecodeErr || rxSfdto || affrej);
-}
-
-bool dwIsReceiveTimeout(dwDevice_t* dev) {
-	return getBit(dev->sysstatus, LEN_SYS_STATUS, RXRFTO_BIT);
-}
-
-bool dwIsClockProblem(dwDevice_t* dev) {
-	bool clkllErr, rfllErr;
-	clkllErr = getBit(dev->sysstatus, LEN_SYS_STATUS, CLKPLL_LL_BIT);
-	rfllErr = getBit(dev->sysstatus, LEN_SYS_STATUS, RFPLL_LL_BIT);
-	if(clkllErr || rfllErr) {
-		return true;
-	}
-	return false;
-}
-
 void dwClearAllStatus(dwDevice_t* dev) {
-	memset(dev->sysstatus, 0, LEN_SYS_STATUS);
+	dev->sysstatus = 0;
 	uint32_t reg = 0xffffffff;
-	dwSpiWrite(dev, SYS_STATUS, NO_SUB,  &reg, LEN_SYS_STATUS);
+	dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, &reg, LEN_SYS_STATUS);
 }
 
 void dwClearReceiveTimestampAvailableStatus(dwDevice_t* dev) {
-	uint8_t reg[LEN_SYS_STATUS] = {0};
-	setBit(reg, LEN_SYS_STATUS, LDEDONE_BIT, true);
-	dwSpiWrite(dev, SYS_STATUS, NO_SUB, reg, LEN_SYS_STATUS);
+	uint32_t regData = 1ul << LDEDONE_BIT;
+	dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, &regData, sizeof(regData));
 }
 
 void dwClearReceiveStatus(dwDevice_t* dev) {
 	// clear latched RX bits (i.e. write 1 to clear)
 	uint32_t regData = SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR | SYS_STATUS_ALL_RX_GOOD;
-	dwSpiWrite32(dev, SYS_STATUS, NO_SUB, regData);
+	dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, &regData, sizeof(regData));
 }
 
 void dwClearTransmitStatus(dwDevice_t* dev) {
 	// clear latched TX bits
 	uint32_t regData = SYS_STATUS_ALL_TX;
-	dwSpiWrite32(dev, SYS_STATUS, NO_SUB, regData);
+	dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, &regData, sizeof(regData));
 }
 
 float dwGetReceiveQuality(dwDevice_t* dev) {
@@ -881,6 +1205,110 @@ float dwGetReceivePower(dwDevice_t* dev) {
 	return calculatePower(C * twoPower17, N, dev->pulseFrequency);
 }
 
+void dwReadReceiveDiagnostics(dwDevice_t* dev, dwRxDiagnostics_t* diag) {
+	uint8_t rxFrameQuality[LEN_RX_FQUAL];
+	uint8_t rxFrameInfo[LEN_RX_FINFO];
+	uint8_t carrierInt[LEN_DRX_CAR_INT];
+	uint8_t ttOffset[LEN_RXTOFS];
+
+	dwSpiRead(dev, RX_FQUAL, NO_SUB, rxFrameQuality, LEN_RX_FQUAL);
+	dwSpiRead(dev, RX_FINFO, NO_SUB, rxFrameInfo, LEN_RX_FINFO);
+	diag->fpAmpl1 = dwSpiRead16(dev, RX_TIME, FP_AMPL1_SUB);
+	dwSpiRead(dev, DRX_TUNE, DRX_CAR_INT_SUB, carrierInt, LEN_DRX_CAR_INT);
+	diag->timeTrackingInterval = dwSpiRead32(dev, RX_TTCKI, NO_SUB);
+	dwSpiRead(dev, RX_TTCKO, NO_SUB, ttOffset, LEN_RXTOFS);
+
+	diag->stdNoise = (uint16_t)rxFrameQuality[0] | ((uint16_t)rxFrameQuality[1] << 8);
+	diag->fpAmpl2 = (uint16_t)rxFrameQuality[2] | ((uint16_t)rxFrameQuality[3] << 8);
+	diag->fpAmpl3 = (uint16_t)rxFrameQuality[4] | ((uint16_t)rxFrameQuality[5] << 8);
+	diag->cirPwr = (uint16_t)rxFrameQuality[6] | ((uint16_t)rxFrameQuality[7] << 8);
+	diag->rxPacc = ((rxFrameInfo[2] >> 4) & 0x0F) | ((uint16_t)rxFrameInfo[3] << 4);
+	diag->carrierIntegrator = signExtend(bytesToValue(carrierInt, LEN_DRX_CAR_INT), 21);
+	diag->timeTrackingOffset = signExtend(bytesToValue(ttOffset, LEN_RXTOFS), 19);
+}
+
+static float clockOffsetPpm(dwDevice_t* dev, int32_t carrierIntegrator) {
+	// Carrier integrator resolution in Hz depends on the data rate, see the
+	// DRX_CAR_INT description in the user manual
+	float hertzPerBit;
+	if(dev->dataRate == TRX_RATE_110KBPS) {
+		hertzPerBit = 998.4e6f / 2.0f / 8192.0f / 131072.0f;
+	} else {
+		hertzPerBit = 998.4e6f / 2.0f / 1024.0f / 131072.0f;
+	}
+
+	float carrierFrequency;
+	if(dev->channel == CHANNEL_1) {
+		carrierFrequency = 3494.4e6f;
+	} else if(dev->channel == CHANNEL_2 || dev->channel == CHANNEL_4) {
+		carrierFrequency = 3993.6e6f;
+	} else if(dev->channel == CHANNEL_3) {
+		carrierFrequency = 4492.8e6f;
+	} else {
+		carrierFrequency = 6489.6e6f;
+	}
+
+	return -(float)carrierIntegrator * hertzPerBit * 1.0e6f / carrierFrequency;
+}
+
+float dwGetClockOffsetPpm(dwDevice_t* dev) {
+	uint8_t carrierInt[LEN_DRX_CAR_INT];
+	dwSpiRead(dev, DRX_TUNE, DRX_CAR_INT_SUB, carrierInt, LEN_DRX_CAR_INT);
+	return clockOffsetPpm(dev, signExtend(bytesToValue(carrierInt, LEN_DRX_CAR_INT), 21));
+}
+
+float dwDiagnosticsClockOffsetPpm(dwDevice_t* dev, const dwRxDiagnostics_t* diag) {
+	return clockOffsetPpm(dev, diag->carrierIntegrator);
+}
+
+float dwDiagnosticsTrackingOffsetPpm(const dwRxDiagnostics_t* diag) {
+	if(diag->timeTrackingInterval == 0) {
+		return 0.0f;
+	}
+	return (float)diag->timeTrackingOffset * 1.0e6f / (float)diag->timeTrackingInterval;
+}
+
+float dwDiagnosticsFirstPathPower(dwDevice_t* dev, const dwRxDiagnostics_t* diag) {
+	float f1 = (float)diag->fpAmpl1;
+	float f2 = (float)diag->fpAmpl2;
+	float f3 = (float)diag->fpAmpl3;
+
+	return calculatePower(f1 * f1 + f2 * f2 + f3 * f3, (float)diag->rxPacc, dev->pulseFrequency);
+}
+
+float dwDiagnosticsReceivePower(dwDevice_t* dev, const dwRxDiagnostics_t* diag) {
+	float twoPower17 = 131072.0f;
+
+	return calculatePower((float)diag->cirPwr * twoPower17, (float)diag->rxPacc, dev->pulseFrequency);
+}
+
+float dwDiagnosticsReceiveQuality(const dwRxDiagnostics_t* diag) {
+	if(diag->stdNoise == 0) {
+		return 0.0f;
+	}
+	return (float)diag->fpAmpl2 / diag->stdNoise;
+}
+
+// Position of 'value' from 'low' (0) to 'high' (1), clamped
+static float ramp(float value, float low, float high) {
+	float position = (value - low) / (high - low);
+	if(position < 0.0f) {
+		return 0.0f;
+	} else if(position > 1.0f) {
+		return 1.0f;
+	}
+	return position;
+}
+
+float dwDiagnosticsNlosProbability(dwDevice_t* dev, const dwRxDiagnostics_t* diag) {
+	float powerDifference = dwDiagnosticsReceivePower(dev, diag) - dwDiagnosticsFirstPathPower(dev, diag);
+	float byPower = ramp(powerDifference, DW_NLOS_LOS_DB, DW_NLOS_NLOS_DB);
+	float byQuality = ramp(dwDiagnosticsReceiveQuality(diag), DW_NLOS_LOS_QUALITY, DW_NLOS_NLOS_QUALITY);
+
+	// Either indicator is enough to suspect the frame
+	return byPower > byQuality ? byPower : byQuality;
+}
+
 void dwEnableMode(dwDevice_t *dev, const uint8_t mode[]) {
 	dwSetDataRate(dev, mode[0]);
 	dwSetPulseFrequency(dev, mode[1]);
@@ -1235,14 +1663,7 @@ void dwTune(dwDevice_t *dev) {
 		// TODO proper error/warning handling
 	}
 	// Crystal calibration from OTP (if available)
-	uint8_t buf_otp[4];
-	readBytesOTP(dev, 0x01E, buf_otp);
-	if (buf_otp[0] == 0) {
-		// No trim value available from OTP, use midrange value of 0x10
-		writeValueToBytes(fsxtalt, ((0x10 & 0x1F) | 0x60), LEN_FS_XTALT);
-	} else {
-		writeValueToBytes(fsxtalt, ((buf_otp[0] & 0x1F) | 0x60), LEN_FS_XTALT);
-	}
+	writeValueToBytes(fsxtalt, crystalTrim(dev), LEN_FS_XTALT);
 	// write configuration back to chip
 	dwSpiWrite(dev, AGC_TUNE, AGC_TUNE1_SUB, agctune1, LEN_AGC_TUNE1);
 	dwSpiWrite(dev, AGC_TUNE, AGC_TUNE2_SUB, agctune2, LEN_AGC_TUNE2);
@@ -1264,46 +1685,177 @@ void dwTune(dwDevice_t *dev) {
 	dwSpiWrite(dev, FS_CTRL, FS_XTALT_SUB, fsxtalt, LEN_FS_XTALT);
 }
 
+static uint8_t crystalTrim(dwDevice_t* dev) {
+	uint8_t buf_otp[4];
+	readBytesOTP(dev, 0x01E, buf_otp);
+	if (buf_otp[0] == 0) {
+		// No trim value available from OTP, use midrange value of 0x10
+		return (0x10 & 0x1F) | 0x60;
+	}
+	return (buf_otp[0] & 0x1F) | 0x60;
+}
+
+#ifdef DW_STATIC_CONFIG
+typedef struct {
+	dwSpiHeader_t header;
+	uint8_t length;
+	uint8_t data[LEN_TX_FCTRL];
+} staticRegister_t;
+
+#define STATIC_REGISTER(regid, address, length, value) {DW_SPI_HEADER_WRITE(regid, address), length, \
+	{(uint8_t)(value), (uint8_t)((value) >> 8), (uint8_t)((value) >> 16), (uint8_t)((value) >> 24), 0}}
+
+// Register image of the compile-time configuration, written in order
+static const staticRegister_t STATIC_CONFIG[] = {
+	STATIC_REGISTER(PANADR, NO_SUB, LEN_PANADR, 0xFFFFFFFFul),
+	STATIC_REGISTER(SYS_CFG, NO_SUB, LEN_SYS_CFG, DW_CONFIG_SYS_CFG),
+	STATIC_REGISTER(CHAN_CTRL, NO_SUB, LEN_CHAN_CTRL, DW_CONFIG_CHAN_CTRL),
+	STATIC_REGISTER(TX_FCTRL, NO_SUB, LEN_TX_FCTRL, DW_CONFIG_TX_FCTRL),
+	STATIC_REGISTER(SYS_MASK, NO_SUB, LEN_SYS_MASK, DW_CONFIG_SYS_MASK),
+	STATIC_REGISTER(USR_SFD, SFD_LENGTH_SUB, LEN_SFD_LENGTH, DW_CONFIG_SFD_LENGTH),
+	STATIC_REGISTER(AGC_TUNE, AGC_TUNE1_SUB, LEN_AGC_TUNE1, DW_CONFIG_AGC_TUNE1),
+	STATIC_REGISTER(AGC_TUNE, AGC_TUNE2_SUB, LEN_AGC_TUNE2, DW_CONFIG_AGC_TUNE2),
+	STATIC_REGISTER(AGC_TUNE, AGC_TUNE3_SUB, LEN_AGC_TUNE3, DW_CONFIG_AGC_TUNE3),
+	STATIC_REGISTER(DRX_TUNE, DRX_TUNE0b_SUB, LEN_DRX_TUNE0b, DW_CONFIG_DRX_TUNE0b),
+	STATIC_REGISTER(DRX_TUNE, DRX_TUNE1a_SUB, LEN_DRX_TUNE1a, DW_CONFIG_DRX_TUNE1a),
+	STATIC_REGISTER(DRX_TUNE, DRX_TUNE1b_SUB, LEN_DRX_TUNE1b, DW_CONFIG_DRX_TUNE1b),
+	STATIC_REGISTER(DRX_TUNE, DRX_TUNE2_SUB, LEN_DRX_TUNE2, DW_CONFIG_DRX_TUNE2),
+	STATIC_REGISTER(DRX_TUNE, DRX_TUNE4H_SUB, LEN_DRX_TUNE4H, DW_CONFIG_DRX_TUNE4H),
+	STATIC_REGISTER(LDE_IF, LDE_CFG1_SUB, LEN_LDE_CFG1, DW_CONFIG_LDE_CFG1),
+	STATIC_REGISTER(LDE_IF, LDE_CFG2_SUB, LEN_LDE_CFG2, DW_CONFIG_LDE_CFG2),
+	STATIC_REGISTER(LDE_IF, LDE_REPC_SUB, LEN_LDE_REPC, DW_CONFIG_LDE_REPC),
+	STATIC_REGISTER(TX_POWER, NO_SUB, LEN_TX_POWER, DW_CONFIG_TX_POWER),
+	STATIC_REGISTER(RF_CONF, RF_RXCTRLH_SUB, LEN_RF_RXCTRLH, DW_CONFIG_RF_RXCTRLH),
+	STATIC_REGISTER(RF_CONF, RF_TXCTRL_SUB, LEN_RF_TXCTRL, DW_CONFIG_RF_TXCTRL),
+	STATIC_REGISTER(TX_CAL, TC_PGDELAY_SUB, LEN_TC_PGDELAY, DW_CONFIG_TC_PGDELAY),
+	STATIC_REGISTER(FS_CTRL, FS_PLLTUNE_SUB, LEN_FS_PLLTUNE, DW_CONFIG_FS_PLLTUNE),
+	STATIC_REGISTER(FS_CTRL, FS_PLLCFG_SUB, LEN_FS_PLLCFG, DW_CONFIG_FS_PLLCFG),
+	STATIC_REGISTER(TX_ANTD, NO_SUB, LEN_TX_ANTD, DW_CONFIG_ANTENNA_DELAY),
+	STATIC_REGISTER(LDE_IF, LDE_RXANTD_SUB, LEN_LDE_RXANTD, DW_CONFIG_ANTENNA_DELAY),
+};
+
+int dwConfigureStatic(dwDevice_t* dev) {
+	int result = dwConfigure(dev);
+	if (result != DW_ERROR_OK) {
+		return result;
+	}
+
+	for (unsigned int i = 0; i < sizeof(STATIC_CONFIG) / sizeof(STATIC_CONFIG[0]); i++) {
+		dwSpiWriteHeader(dev, &STATIC_CONFIG[i].header, STATIC_CONFIG[i].data, STATIC_CONFIG[i].length);
+	}
+	// The crystal trim is specific to each chip
+	uint8_t fsxtalt = crystalTrim(dev);
+	dwSpiWrite(dev, FS_CTRL, FS_XTALT_SUB, &fsxtalt, LEN_FS_XTALT);
+
+	// Driver state matching the register image
+	memset(dev->networkAndAddress, 0xff, LEN_PANADR);
+	dev->syscfg = DW_CONFIG_SYS_CFG;
+	dev->sysmask = DW_CONFIG_SYS_MASK;
+	writeValueToBytes(dev->chanctrl, DW_CONFIG_CHAN_CTRL, LEN_CHAN_CTRL);
+	memset(dev->txfctrl, 0, LEN_TX_FCTRL);
+	writeValueToBytes(dev->txfctrl, DW_CONFIG_TX_FCTRL, 4);
+	dev->extendedFrameLength = FRAME_LENGTH_NORMAL;
+	dev->pacSize = DW_CONFIG_PAC_SIZE;
+	dev->pulseFrequency = DW_CONFIG_PULSE_FREQ;
+	dev->dataRate = DW_CONFIG_DATA_RATE;
+	dev->preambleLength = DW_CONFIG_PREAMBLE_LENGTH;
+	dev->preambleCode = DW_CONFIG_PREAMBLE_CODE;
+	dev->channel = DW_CONFIG_CHANNEL;
+	dev->smartPower = DW_CONFIG_SMART_POWER;
+	dev->frameCheck = true;
+	dev->autoAck = false;
+	dev->antennaDelay.full = DW_CONFIG_ANTENNA_DELAY;
+
+	return DW_ERROR_OK;
+}
+#endif
+
 void dwHandleInterrupt(dwDevice_t *dev) {
 	// read current status and handle via callbacks
+	DW_OPS_LOCK(dev);
 	dwReadSystemEventStatusRegister(dev);
-	if(dwIsClockProblem(dev) /* TODO and others */ && dev->handleError != 0) {
-		(*dev->handleError)(dev);
+	if(dwIsClockProblem(dev) /* TODO and others */ && DW_HANDLER(dev, handleError) != 0) {
+		DW_HANDLER(dev, handleError)(dev);
+	}
+	// AAT together with a good frame means the chip is sending an acknowledge,
+	// its TXFRS may come in this or a later interrupt
+	if(dev->autoAck && (dev->sysstatus & (1ull << AAT_BIT)) && dwIsReceiveDone(dev)) {
+		dev->ackPending = true;
+	}
+
+	bool ackSent = dwIsTransmitDone(dev) && dev->ackPending;
+	bool sent = !ackSent && dwIsTransmitDone(dev) && DW_HANDLER(dev, handleSent) != 0;
+	bool timestampAvailable = dwIsReceiveTimestampAvailable(dev) && DW_HANDLER(dev, handleReceiveTimestampAvailable) != 0;
+	bool receiveFailed = dwIsReceiveFailed(dev);
+	bool receiveTimeout = !receiveFailed && dwIsReceiveTimeout(dev);
+	bool received = !receiveFailed && !receiveTimeout && dwIsReceiveDone(dev) && DW_HANDLER(dev, handleReceived) != 0;
+
+	// Acknowledge all handled events with a single write (write 1 to clear),
+	// before any callback can start a new transmission or reception
+	uint32_t handled = 0;
+	if(ackSent || sent) {
+		handled |= SYS_STATUS_ALL_TX;
 	}
-	if(dwIsTransmitDone(dev) && dev->handleSent != 0) {
-		dwClearTransmitStatus(dev);
-		(*dev->handleSent)(dev);
+	if(timestampAvailable) {
+		handled |= 1ul << LDEDONE_BIT;
+	}
+	if(receiveFailed || receiveTimeout || received) {
+		handled |= SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR | SYS_STATUS_ALL_RX_GOOD;
+	}
+	if(handled) {
+		dwSpiWriteHeader(dev, &SYS_STATUS_WRITE, &handled, sizeof(handled));
+	}
+	if(ackSent) {
+		dev->ackPending = false;
+	}
+	DW_OPS_UNLOCK(dev);
+
+	if(ackSent) {
+		if(dev->permanentReceive) {
+			// A frame received in the same interrupt is read by its handler
+			// first, the receiver is then re-enabled once below
+			if(!received) {
+				restartReceive(dev);
+			}
+		} else if(dev->wait4resp) {
+			// The chip wrongly applies WAIT4RESP after an automatic acknowledge,
+			// see "Transmit and automatically wait for response" in the user manual
+			dwIdle(dev);
+			dwRxSoftReset(dev);
+		}
+	} else if(sent) {
+		DW_HANDLER(dev, handleSent)(dev);
 	}
-	if(dwIsReceiveTimestampAvailable(dev) && dev->handleReceiveTimestampAvailable != 0) {
-		dwClearReceiveTimestampAvailableStatus(dev);
-		(*dev->handleReceiveTimestampAvailable)(dev);
+	if(timestampAvailable) {
+		DW_HANDLER(dev, handleReceiveTimestampAvailable)(dev);
 	}
-	if(dwIsReceiveFailed(dev)) {
-		dwClearReceiveStatus(dev);
+	if(receiveFailed) {
 		dwRxSoftReset(dev); // Needed due to error in the RX auto-re-enable functionality. See page 35 of DW1000 manual, v2.13.
-		if(dev->handleReceiveFailed != 0) {
-			dev->handleReceiveFailed(dev);
+		if(DW_HANDLER(dev, handleReceiveFailed) != 0) {
+			DW_HANDLER(dev, handleReceiveFailed)(dev);
 			if(dev->permanentReceive) {
-				dwNewReceive(dev);
-				dwStartReceive(dev);
+				restartReceive(dev);
 			}
 		}
-	} else if(dwIsReceiveTimeout(dev)) {
-		dwClearReceiveStatus(dev);
+	} else if(receiveTimeout) {
 		dwRxSoftReset(dev); // Needed due to error in the RX auto-re-enable functionality. See page 35 of DW1000 manual, v2.13.
-		if(dev->handleReceiveTimeout != 0) {
-			(*dev->handleReceiveTimeout)(dev);
+		if(DW_HANDLER(dev, handleReceiveTimeout) != 0) {
+			DW_HANDLER(dev, handleReceiveTimeout)(dev);
 			if(dev->permanentReceive) {
-				dwNewReceive(dev);
-				dwStartReceive(dev);
+				restartReceive(dev);
 			}
 		}
-	} else if(dwIsReceiveDone(dev) && dev->handleReceived != 0) {
-		dwClearReceiveStatus(dev);
-		(*dev->handleReceived)(dev);
-		if(dev->permanentReceive) {
-			dwNewReceive(dev);
-			dwStartReceive(dev);
+	} else if(received && DW_HANDLER(dev, acceptFrame) != 0 && !DW_HANDLER(dev, acceptFrame)(dev)) {
+		// Dropped frame, listen again as if nothing had been received
+		if(!dev->ackPending) {
+			restartReceive(dev);
+		}
+	} else if(received) {
+		DW_HANDLER(dev, handleReceived)(dev);
+		// Going idle would abort a pending acknowledge, the receiver is
+		// re-enabled once it has been sent
+		if(dev->permanentReceive && !dev->ackPending) {
+			restartReceive(dev);
 		}
 	}
 }
@@ -1315,29 +1867,39 @@ void dwSetTxPower(dwDevice_t *dev, uint32_t txPower)
 }
 
 void dwAttachSentHandler(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleSent = handler;
+	DW_ATTACH(dev, handleSent, handler);
 }
 
 void dwAttachErrorHandler(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleError = handler;
+	DW_ATTACH(dev, handleError, handler);
 }
 
 void dwAttachReceivedHandler(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleReceived = handler;
+	DW_ATTACH(dev, handleReceived, handler);
 }
 
 void dwAttachReceiveTimeoutHandler(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleReceiveTimeout = handler;
+	DW_ATTACH(dev, handleReceiveTimeout, handler);
 }
 
 void dwAttachReceiveFailedHandler(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleReceiveFailed = handler;
+	DW_ATTACH(dev, handleReceiveFailed, handler);
 }
 
 void dwAttachReceiveTimestampAvailable(dwDevice_t *dev, dwHandler_t handler) {
-	dev->handleReceiveTimestampAvailable = handler;
+	DW_ATTACH(dev, handleReceiveTimestampAvailable, handler);
+}
+
+void dwAttachReceiveFilter(dwDevice_t *dev, dwFrameFilter_t filter) {
+	DW_ATTACH(dev, acceptFrame, filter);
 }
 
+#ifdef DW_COMPACT_DEVICE
+void dwSetHandlers(dwDevice_t *dev, dwHandlers_t *handlers) {
+	dev->handlers = handlers;
+}
+#endif
+
 void dwSetAntenaDelay(dwDevice_t *dev, dwTime_t delay) {
 	dev->antennaDelay.full = delay.full;
 }
@@ -1346,6 +1908,8 @@ char* dwStrError(int error)
 {
 	if (error == DW_ERROR_OK) return "No error";
 	else if (error == DW_ERROR_WRONG_ID) return "Wrong chip ID";
+	else if (error == DW_ERROR_LATE_SCHEDULE) return "Delayed transmission or reception scheduled too late";
+	else if (error == DW_ERROR_BUS_FULL) return "No free device slot on the bus";
 	else return "Uknown error";
 }
 
@@ -1366,18 +1930,12 @@ static void setBit(uint8_t data[], unsigned int n, unsigned int bit, bool val) {
 	}
 }
 
-static bool getBit(uint8_t data[], unsigned int n, unsigned int bit) {
-	unsigned int idx;
-	unsigned int shift;
-
-	idx = bit / 8;
-	if(idx >= n) {
-		return false; // TODO proper error handling: out of bounds
+static inline void setBits(uint32_t* reg, uint32_t mask, bool val) {
+	if(val) {
+		*reg |= mask;
+	} else {
+		*reg &= ~mask;
 	}
-	uint8_t targetByte = data[idx];
-	shift = bit % 8;
-
-	return (targetByte>>shift)&0x01;
 }
 
 static void writeValueToBytes(uint8_t data[], long val, unsigned int n) {
@@ -1387,6 +1945,21 @@ static void writeValueToBytes(uint8_t data[], long val, unsigned int n) {
 	}
 }
 
+static uint32_t bytesToValue(const uint8_t data[], unsigned int n) {
+	uint32_t val = 0;
+	unsigned int i;
+	for(i = 0; i < n; i++) {
+		val |= ((uint32_t)data[i] << (i * 8));
+	}
+	return val;
+}
+
+static int32_t signExtend(uint32_t value, unsigned int bits) {
+	uint32_t signBit = 1ul << (bits - 1);
+	value &= (signBit << 1) - 1;
+	return (int32_t)(value ^ signBit) - (int32_t)signBit;
+}
+
 static void readBytesOTP(dwDevice_t* dev, uint16_t address, uint8_t data[]) {
 	uint8_t addressBytes[LEN_OTP_ADDR];
 
@@ -1394,6 +1967,7 @@ static void readBytesOTP(dwDevice_t* dev, uint16_t address, uint8_t data[]) {
 	// bytes of address
 	addressBytes[0] = (address & 0xFF);
 	addressBytes[1] = ((address >> 8) & 0xFF);
+	DW_OPS_LOCK(dev);
 	// set address
 	dwSpiWrite(dev, OTP_IF, OTP_ADDR_SUB, addressBytes, LEN_OTP_ADDR);
 	// switch into read mode
@@ -1403,4 +1977,5 @@ static void readBytesOTP(dwDevice_t* dev, uint16_t address, uint8_t data[]) {
 	dwSpiRead(dev, OTP_IF, OTP_RDAT_SUB, data, LEN_OTP_RDAT);
 	// end read mode
 	dwSpiWrite8(dev, OTP_IF, OTP_CTRL_SUB, 0x00);
+	DW_OPS_UNLOCK(dev);
 }
@@ -0,0 +1,132 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000AddressFilter.h"
+#include "libdw1000Hash.h"
+#include "libdw1000Mac.h"
+#include "libdw1000.h"
+
+#if (DW_ADDRESS_FILTER_SIZE & (DW_ADDRESS_FILTER_SIZE - 1)) != 0
+#error "DW_ADDRESS_FILTER_SIZE must be a power of two"
+#endif
+
+#define SHORT_KEY(pan, address) (0xFFFF000000000000ull | ((uint64_t)(pan) << 16) | (address))
+
+// Frame control, sequence number, destination PAN and extended address
+#define MAX_HEADER_LENGTH 13
+
+static bool contains(const dwAddressFilter_t *filter, uint64_t key) {
+	return filter->key[dwHashProbe(filter->key, DW_ADDRESS_FILTER_SIZE, key)] == key;
+}
+
+// Frames to the broadcast PAN reach the short address in any PAN
+static bool containsInAnyPan(const dwAddressFilter_t *filter, uint16_t address) {
+	for(int i = 0; i < DW_ADDRESS_FILTER_SIZE; i++) {
+		uint64_t key = filter->key[i];
+		if(key != DW_HASH_EMPTY && (key >> 48) == 0xFFFF && (uint16_t)key == address) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool add(dwAddressFilter_t *filter, uint64_t key) {
+	unsigned int i = dwHashProbe(filter->key, DW_ADDRESS_FILTER_SIZE, key);
+	if(filter->key[i] == key) {
+		return true;
+	}
+	if(filter->count >= DW_ADDRESS_FILTER_CAPACITY) {
+		return false;
+	}
+	filter->key[i] = key;
+	filter->count++;
+	return true;
+}
+
+void dwAddressFilterInit(dwAddressFilter_t *filter) {
+	for(int i = 0; i < DW_ADDRESS_FILTER_SIZE; i++) {
+		filter->key[i] = DW_HASH_EMPTY;
+	}
+	filter->count = 0;
+	filter->acceptBroadcast = true;
+}
+
+bool dwAddressFilterAddShort(dwAddressFilter_t *filter, uint16_t pan, uint16_t address) {
+	return add(filter, SHORT_KEY(pan, address));
+}
+
+bool dwAddressFilterAddExtended(dwAddressFilter_t *filter, uint64_t address) {
+	if(address == DW_HASH_EMPTY) {
+		return false;
+	}
+	return add(filter, address);
+}
+
+bool dwAddressFilterMatch(const dwAddressFilter_t *filter, const uint8_t *frame, size_t length) {
+	if(length < 1) {
+		return false;
+	}
+	// Other types, such as blinks and clock sync beacons, have a one byte
+	// frame control and no destination
+	if(dwMacFrameType(frame) > DW_MAC_TYPE_MAC_COMMAND) {
+		return true;
+	}
+	if(length < 3) {
+		return false;
+	}
+	uint8_t mode = dwMacDestinationMode(frame);
+	if(mode == DW_MAC_ADDRESS_SHORT) {
+		if(length < 7) {
+			return false;
+		}
+		uint16_t pan = frame[3] | ((uint16_t)frame[4] << 8);
+		uint16_t address = frame[5] | ((uint16_t)frame[6] << 8);
+		if(address == DW_MAC_BROADCAST) {
+			return filter->acceptBroadcast;
+		}
+		if(pan == DW_MAC_BROADCAST) {
+			return containsInAnyPan(filter, address);
+		}
+		return contains(filter, SHORT_KEY(pan, address));
+	} else if(mode == DW_MAC_ADDRESS_EXTENDED) {
+		if(length < MAX_HEADER_LENGTH) {
+			return false;
+		}
+		// Little endian, as the supported MCUs. Extended addresses are
+		// accepted in any PAN.
+		uint64_t address;
+		memcpy(&address, &frame[5], sizeof(address));
+		return contains(filter, address);
+	}
+	// No destination address, or reserved mode that the chip rejects
+	return true;
+}
+
+bool dwAddressFilterAccept(dwDevice_t *dev, const dwAddressFilter_t *filter) {
+	uint8_t header[MAX_HEADER_LENGTH];
+	unsigned int length = dwGetDataLength(dev);
+	if(length > MAX_HEADER_LENGTH) {
+		length = MAX_HEADER_LENGTH;
+	}
+	dwGetData(dev, header, length);
+	return dwAddressFilterMatch(filter, header, length);
+}
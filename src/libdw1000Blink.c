@@ -0,0 +1,58 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000Blink.h"
+#include "libdw1000.h"
+#include "libdw1000Spi.h"
+
+static const dwSpiHeader_t TX_BUFFER_WRITE = DW_SPI_HEADER_WRITE(TX_BUFFER, NO_SUB);
+static const dwSpiHeader_t TX_FCTRL_WRITE = DW_SPI_HEADER_WRITE(TX_FCTRL, NO_SUB);
+static const dwSpiHeader_t SYS_CTRL_WRITE = DW_SPI_HEADER_WRITE(SYS_CTRL, NO_SUB);
+
+#define SEQUENCE_INDEX 1
+#define TAG_ID_INDEX 2
+
+void dwBlinkInit(dwDevice_t *dev, dwBlink_t *blink, uint64_t tagId) {
+	blink->frame[0] = DW_BLINK_FRAME_CONTROL;
+	blink->frame[SEQUENCE_INDEX] = 0;
+	for(int i = 0; i < 8; i++) {
+		blink->frame[TAG_ID_INDEX + i] = (uint8_t)(tagId >> (i * 8));
+	}
+
+	// Frame length with the CRC added by the chip
+	unsigned int length = DW_BLINK_FRAME_LENGTH + 2;
+	memcpy(blink->txfctrl, dev->txfctrl, LEN_TX_FCTRL);
+	blink->txfctrl[0] = (uint8_t)length;
+	blink->txfctrl[1] &= 0xE0;
+
+	dwConfigureSleep(dev, false);
+	dwEnterSleepAfterTransmit(dev, true);
+}
+
+void dwBlinkSend(dwDevice_t *dev, dwBlink_t *blink) {
+	static const uint8_t start = 1u << TXSTRT_BIT;
+
+	dwSpiWriteHeader(dev, &TX_BUFFER_WRITE, blink->frame, DW_BLINK_FRAME_LENGTH);
+	dwSpiWriteHeader(dev, &TX_FCTRL_WRITE, blink->txfctrl, LEN_TX_FCTRL);
+	dwSpiWriteHeader(dev, &SYS_CTRL_WRITE, &start, sizeof(start));
+	blink->frame[SEQUENCE_INDEX]++;
+}
@@ -0,0 +1,211 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libdw1000Bus.h"
+#include "libdw1000.h"
+
+#ifndef DW_STATIC_OPS
+
+#define SPEED_UNKNOWN 0xff
+
+static bool busTryLock(dwBus_t *bus)
+{
+	if(bus->ops->tryLock) {
+		if(!bus->ops->tryLock(bus)) {
+			return false;
+		}
+	} else if(bus->depth != 0) {
+		return false;
+	}
+	bus->depth++;
+	return true;
+}
+
+static void busLock(dwBus_t *bus)
+{
+	if(bus->ops->lock) {
+		bus->ops->lock(bus);
+	}
+	bus->depth++;
+}
+
+static bool busHasPending(dwBus_t *bus)
+{
+	for(int i = 0; i < bus->deviceCount; i++) {
+		if(bus->devices[i]->pending) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void busUnlock(dwBus_t *bus)
+{
+	// Service the queued interrupts before releasing the bus
+	while(bus->depth == 1 && busHasPending(bus)) {
+		for(int i = 0; i < bus->deviceCount; i++) {
+			dwBusDevice_t *busDevice = bus->devices[i];
+			if(busDevice->pending) {
+				busDevice->pending = 0;
+				dwHandleInterrupt(&busDevice->dev);
+			}
+		}
+	}
+
+	bus->depth--;
+	if(bus->ops->unlock) {
+		bus->ops->unlock(bus);
+	}
+
+	// An interrupt may have been queued between the last check and the unlock
+	if(bus->depth == 0 && busHasPending(bus) && busTryLock(bus)) {
+		busUnlock(bus);
+	}
+}
+
+static void busSelectSpeed(dwBusDevice_t *busDevice)
+{
+	dwBus_t *bus = busDevice->bus;
+	if(bus->speed != busDevice->speed) {
+		bus->ops->spiSetSpeed(bus, (dwSpiSpeed_t)busDevice->speed);
+		bus->speed = busDevice->speed;
+	}
+}
+
+static void spiRead(dwDevice_t* dev, const void *header, size_t headerLength,
+                                     void* data, size_t dataLength)
+{
+	dwBusDevice_t *busDevice = (dwBusDevice_t *)dev;
+	dwBus_t *bus = busDevice->bus;
+
+	busLock(bus);
+	busSelectSpeed(busDevice);
+	bus->ops->spiRead(bus, busDevice->cs, header, headerLength, data, dataLength);
+	busUnlock(bus);
+}
+
+static void spiWrite(dwDevice_t* dev, const void *header, size_t headerLength,
+                                      const void* data, size_t dataLength)
+{
+	dwBusDevice_t *busDevice = (dwBusDevice_t *)dev;
+	dwBus_t *bus = busDevice->bus;
+
+	busLock(bus);
+	busSelectSpeed(busDevice);
+	bus->ops->spiWrite(bus, busDevice->cs, header, headerLength, data, dataLength);
+	busUnlock(bus);
+}
+
+static void spiSetSpeed(dwDevice_t* dev, dwSpiSpeed_t speed)
+{
+	// Applied at the next transfer of the device
+	((dwBusDevice_t *)dev)->speed = speed;
+}
+
+static void delayms(dwDevice_t* dev, unsigned int delay)
+{
+	dwBus_t *bus = ((dwBusDevice_t *)dev)->bus;
+	bus->ops->delayms(bus, delay);
+}
+
+static void delayus(dwDevice_t* dev, unsigned int delay)
+{
+	dwBus_t *bus = ((dwBusDevice_t *)dev)->bus;
+	if(bus->ops->delayus) {
+		bus->ops->delayus(bus, delay);
+	} else {
+		bus->ops->delayms(bus, (delay + 999) / 1000);
+	}
+}
+
+static void reset(dwDevice_t* dev)
+{
+	dwBusDevice_t *busDevice = (dwBusDevice_t *)dev;
+	dwBus_t *bus = busDevice->bus;
+
+	if(bus->ops->reset) {
+		bus->ops->reset(bus, busDevice->cs);
+	} else {
+		dwSoftReset(dev);
+	}
+}
+
+static void lock(dwDevice_t* dev)
+{
+	busLock(((dwBusDevice_t *)dev)->bus);
+}
+
+static void unlock(dwDevice_t* dev)
+{
+	busUnlock(((dwBusDevice_t *)dev)->bus);
+}
+
+static dwOps_t busDeviceOps = {
+	.spiRead = spiRead,
+	.spiWrite = spiWrite,
+	.spiSetSpeed = spiSetSpeed,
+	.delayms = delayms,
+	.reset = reset,
+	.lock = lock,
+	.unlock = unlock,
+	.delayus = delayus,
+};
+
+void dwBusInit(dwBus_t *bus, const dwBusOps_t *ops)
+{
+	bus->ops = ops;
+	bus->userdata = NULL;
+	bus->deviceCount = 0;
+	bus->depth = 0;
+	bus->speed = SPEED_UNKNOWN;
+}
+
+int dwBusAttach(dwBus_t *bus, dwBusDevice_t *busDevice, uint8_t cs)
+{
+	if(bus->deviceCount >= DW_BUS_MAX_DEVICES) {
+		return DW_ERROR_BUS_FULL;
+	}
+
+	dwInit(&busDevice->dev, &busDeviceOps);
+	busDevice->bus = bus;
+	busDevice->cs = cs;
+	busDevice->speed = dwSpiSpeedLow;
+	busDevice->pending = 0;
+
+	busLock(bus);
+	bus->devices[bus->deviceCount++] = busDevice;
+	busUnlock(bus);
+
+	return DW_ERROR_OK;
+}
+
+void dwBusHandleInterrupt(dwBusDevice_t *busDevice)
+{
+	dwBus_t *bus = busDevice->bus;
+
+	if(busTryLock(bus)) {
+		dwHandleInterrupt(&busDevice->dev);
+		busUnlock(bus);
+	} else {
+		busDevice->pending = 1;
+	}
+}
+
+#endif // DW_STATIC_OPS
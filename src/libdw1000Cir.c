@@ -0,0 +1,103 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000Cir.h"
+#include "libdw1000Spi.h"
+
+#define SAMPLE_LENGTH 4
+
+// Forces the RX and accumulator clocks on, as needed to read ACC_MEM
+static void enableClocks(dwDevice_t *dev) {
+	uint8_t pmscctrl0[2];
+	DW_OPS_LOCK(dev);
+	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, sizeof(pmscctrl0));
+	pmscctrl0[0] = (pmscctrl0[0] & ~(RXCLKS_MASK | (1u << FACE_BIT))) | RXCLKS_PLL | (1u << FACE_BIT);
+	pmscctrl0[1] |= 1u << (AMCE_BIT - 8);
+	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, sizeof(pmscctrl0));
+	DW_OPS_UNLOCK(dev);
+}
+
+// Back to the automatic RX clock
+static void disableClocks(dwDevice_t *dev) {
+	uint8_t pmscctrl0[2];
+	DW_OPS_LOCK(dev);
+	dwSpiRead(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, sizeof(pmscctrl0));
+	pmscctrl0[0] &= ~(RXCLKS_MASK | (1u << FACE_BIT));
+	pmscctrl0[1] &= ~(1u << (AMCE_BIT - 8));
+	dwSpiWrite(dev, PMSC, PMSC_CTRL0_SUB, pmscctrl0, sizeof(pmscctrl0));
+	DW_OPS_UNLOCK(dev);
+}
+
+void dwCirStart(dwDevice_t *dev, dwCirReader_t *reader, dwCirSample_t samples[],
+                unsigned int before, unsigned int count) {
+	unsigned int length = dev->pulseFrequency == TX_PULSE_FREQ_16MHZ ? DW_CIR_LENGTH_16MHZ : DW_CIR_LENGTH_64MHZ;
+
+	reader->firstPathIndex = dwSpiRead16(dev, RX_TIME, FP_INDEX_SUB);
+	unsigned int index = reader->firstPathIndex >> 6;
+	unsigned int first = index > before ? index - before : 0;
+	if(first > length) {
+		first = length;
+	}
+	if(count > length - first) {
+		count = length - first;
+	}
+
+	reader->samples = samples;
+	reader->first = (uint16_t)first;
+	reader->count = (uint16_t)count;
+	reader->read = 0;
+	reader->active = true;
+	enableClocks(dev);
+}
+
+bool dwCirRead(dwDevice_t *dev, dwCirReader_t *reader) {
+	if(!reader->active) {
+		return true;
+	}
+
+	unsigned int n = reader->count - reader->read;
+	if(n > DW_CIR_CHUNK) {
+		n = DW_CIR_CHUNK;
+	}
+	if(n > 0) {
+		// The first byte of each read is a dummy byte
+		uint8_t buffer[1 + DW_CIR_CHUNK * SAMPLE_LENGTH];
+		uint32_t address = (uint32_t)(reader->first + reader->read) * SAMPLE_LENGTH;
+		dwSpiRead(dev, ACC_MEM, address, buffer, 1 + n * SAMPLE_LENGTH);
+		// Little endian, as the supported MCUs
+		memcpy(&reader->samples[reader->read], &buffer[1], n * SAMPLE_LENGTH);
+		reader->read += n;
+	}
+
+	if(reader->read < reader->count) {
+		return false;
+	}
+	dwCirStop(dev, reader);
+	return true;
+}
+
+void dwCirStop(dwDevice_t *dev, dwCirReader_t *reader) {
+	if(reader->active) {
+		reader->active = false;
+		disableClocks(dev);
+	}
+}
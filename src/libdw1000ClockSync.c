@@ -0,0 +1,203 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "libdw1000ClockSync.h"
+#include "libdw1000.h"
+
+#define TIME_SIGN_BIT (1ull << 39)
+
+// Difference of two device times, in the range of +/- half a counter period
+static int64_t signedTime(uint64_t time) {
+	time &= TIME_MASK;
+	if(time & TIME_SIGN_BIT) {
+		return (int64_t)time - (int64_t)(TIME_MASK + 1);
+	}
+	return (int64_t)time;
+}
+
+void dwClockSyncInit(dwClockSync_t *sync, uint8_t masterId) {
+	memset(sync, 0, sizeof(dwClockSync_t));
+	sync->masterId = masterId;
+}
+
+unsigned int dwClockSyncEncodeBeacon(uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH],
+                                     uint8_t masterId, uint8_t sequence,
+                                     const dwTime_t *txTime) {
+	data[0] = DW_CLOCKSYNC_BEACON_TYPE;
+	data[1] = masterId;
+	data[2] = sequence;
+	memcpy(&data[3], txTime->raw, 5);
+	return DW_CLOCKSYNC_BEACON_LENGTH;
+}
+
+bool dwClockSyncDecodeBeacon(const uint8_t data[], unsigned int length,
+                             uint8_t *masterId, uint8_t *sequence,
+                             dwTime_t *txTime) {
+	if(length != DW_CLOCKSYNC_BEACON_LENGTH || data[0] != DW_CLOCKSYNC_BEACON_TYPE) {
+		return false;
+	}
+	*masterId = data[1];
+	*sequence = data[2];
+	txTime->full = 0;
+	memcpy(txTime->raw, &data[3], 5);
+	return true;
+}
+
+int dwClockSyncSendBeacon(dwDevice_t *dev, uint8_t masterId, uint8_t sequence,
+                          const dwTime_t *delay) {
+	uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH];
+
+	dwLock(dev);
+	dwNewTransmit(dev);
+	dwTime_t txTime = dwSetDelay(dev, delay);
+	dwClockSyncEncodeBeacon(data, masterId, sequence, &txTime);
+	dwSetData(dev, data, DW_CLOCKSYNC_BEACON_LENGTH);
+	int result = dwStartTransmit(dev);
+	dwUnlock(dev);
+
+	return result;
+}
+
+static void push(dwClockSync_t *sync, int64_t local, int64_t offset) {
+	sync->head = (sync->head + 1) % DW_CLOCKSYNC_WINDOW;
+	sync->local[sync->head] = local;
+	sync->offset[sync->head] = offset;
+	if(sync->count < DW_CLOCKSYNC_WINDOW) {
+		sync->count++;
+	}
+}
+
+// Least squares fit of the offset against the local time, relative to the
+// last beacon so that the values stay small
+static void fit(dwClockSync_t *sync) {
+	int64_t lastLocal = sync->local[sync->head];
+	int64_t lastOffset = sync->offset[sync->head];
+	double meanX = 0, meanY = 0;
+
+	for(int i = 0; i < sync->count; i++) {
+		meanX += (double)(sync->local[i] - lastLocal);
+		meanY += (double)(sync->offset[i] - lastOffset);
+	}
+	meanX /= sync->count;
+	meanY /= sync->count;
+
+	double sxx = 0, sxy = 0;
+	for(int i = 0; i < sync->count; i++) {
+		double dx = (double)(sync->local[i] - lastLocal) - meanX;
+		double dy = (double)(sync->offset[i] - lastOffset) - meanY;
+		sxx += dx * dx;
+		sxy += dx * dy;
+	}
+
+	if(sxx > 0) {
+		sync->drift = sxy / sxx;
+	} else {
+		sync->drift = 0;
+	}
+	sync->fittedOffset = (double)lastOffset + meanY - sync->drift * meanX;
+}
+
+static void restart(dwClockSync_t *sync, uint64_t master, uint64_t local) {
+	// The samples fill the window from index 0
+	sync->count = 0;
+	sync->head = DW_CLOCKSYNC_WINDOW - 1;
+	push(sync, 0, (int64_t)((master - local) & TIME_MASK));
+	fit(sync);
+}
+
+bool dwClockSyncUpdate(dwClockSync_t *sync, const dwTime_t *masterTx,
+                       const dwTime_t *localRx) {
+	uint64_t master = (masterTx->full + sync->propagation.full) & TIME_MASK;
+	uint64_t local = localRx->full & TIME_MASK;
+	bool used = true;
+
+	if(sync->count == 0) {
+		restart(sync, master, local);
+	} else {
+		// Unwrap, the beacons must be less than a counter period (~17.2s) apart
+		int64_t elapsed = (int64_t)((local - sync->lastLocal.full) & TIME_MASK);
+		int64_t x = sync->local[sync->head] + elapsed;
+		int64_t y = sync->offset[sync->head] +
+		            signedTime((master - local) - (sync->lastMaster.full - sync->lastLocal.full));
+
+		double predicted = sync->fittedOffset + sync->drift * (double)elapsed;
+		if(sync->count >= 2 && fabs((double)y - predicted) > DW_CLOCKSYNC_MAX_ERROR) {
+			sync->mismatches++;
+			if(sync->mismatches < DW_CLOCKSYNC_MAX_MISMATCHES) {
+				// Outlier, the fit and the last beacon are kept
+				return false;
+			}
+			restart(sync, master, local);
+			used = false;
+		} else {
+			push(sync, x, y);
+			fit(sync);
+		}
+	}
+	sync->mismatches = 0;
+
+	sync->lastLocal.full = local;
+	sync->lastMaster.full = master;
+	return used;
+}
+
+bool dwClockSyncHandleBeacon(dwClockSync_t *sync, const uint8_t data[],
+                             unsigned int length, const dwTime_t *localRx) {
+	uint8_t masterId;
+	uint8_t sequence;
+	dwTime_t masterTx;
+
+	if(!dwClockSyncDecodeBeacon(data, length, &masterId, &sequence, &masterTx) ||
+	   masterId != sync->masterId) {
+		return false;
+	}
+	sync->lastSequence = sequence;
+	return dwClockSyncUpdate(sync, &masterTx, localRx);
+}
+
+bool dwClockSyncIsSynchronized(const dwClockSync_t *sync) {
+	return sync->count >= 2;
+}
+
+static int64_t offsetAt(const dwClockSync_t *sync, uint64_t local) {
+	int64_t elapsed = signedTime(local - sync->lastLocal.full);
+	return (int64_t)llround(sync->fittedOffset + sync->drift * (double)elapsed);
+}
+
+dwTime_t dwClockSyncToNetwork(const dwClockSync_t *sync, const dwTime_t *local) {
+	dwTime_t network;
+	network.full = (local->full + (uint64_t)offsetAt(sync, local->full)) & TIME_MASK;
+	return network;
+}
+
+dwTime_t dwClockSyncToLocal(const dwClockSync_t *sync, const dwTime_t *network) {
+	// The offset changes by the drift only, one iteration is enough
+	uint64_t local = network->full - (uint64_t)llround(sync->fittedOffset);
+	dwTime_t result;
+	result.full = (network->full - (uint64_t)offsetAt(sync, local)) & TIME_MASK;
+	return result;
+}
+
+double dwClockSyncDriftPpm(const dwClockSync_t *sync) {
+	return sync->drift * 1e6;
+}
@@ -0,0 +1,146 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000Mac.h"
+
+// Frame control fields
+#define TYPE_MASK 0x0007
+#define SECURITY_BIT 3
+#define FRAME_PENDING_BIT 4
+#define ACK_REQUEST_BIT 5
+#define PAN_COMPRESSION_BIT 6
+#define VERSION_SHIFT 12
+#define SOURCE_MODE_SHIFT 14
+
+#define MODE_RESERVED 1
+
+static const uint8_t ADDRESS_LENGTH[4] = {0, 0, 2, 8};
+
+// The source PAN id is omitted when compressed and both addresses are present
+static inline bool hasSourcePan(uint8_t destinationMode, uint8_t sourceMode, bool panCompression) {
+	return sourceMode != DW_MAC_ADDRESS_NONE &&
+	       !(panCompression && destinationMode != DW_MAC_ADDRESS_NONE);
+}
+
+// Addresses and PAN ids are little endian, as the supported MCUs
+static inline void writeAddress(uint8_t *buffer, uint64_t address, uint8_t length) {
+	memcpy(buffer, &address, length);
+}
+
+static inline uint64_t readAddress(const uint8_t *buffer, uint8_t length) {
+	uint64_t address = 0;
+	memcpy(&address, buffer, length);
+	return address;
+}
+
+size_t dwMacHeaderLength(const dwMacHeader_t *header) {
+	size_t length = 3 + ADDRESS_LENGTH[header->destinationMode & 3] + ADDRESS_LENGTH[header->sourceMode & 3];
+	if(header->destinationMode != DW_MAC_ADDRESS_NONE) {
+		length += 2;
+	}
+	if(hasSourcePan(header->destinationMode, header->sourceMode, header->panCompression)) {
+		length += 2;
+	}
+	return length;
+}
+
+size_t dwMacEncode(uint8_t *buffer, const dwMacHeader_t *header) {
+	uint8_t destinationLength = ADDRESS_LENGTH[header->destinationMode & 3];
+	uint8_t sourceLength = ADDRESS_LENGTH[header->sourceMode & 3];
+	bool panCompression = header->panCompression &&
+	                      destinationLength != 0 && sourceLength != 0;
+
+	uint16_t frameControl = (header->type & TYPE_MASK) |
+	                        ((uint16_t)header->framePending << FRAME_PENDING_BIT) |
+	                        ((uint16_t)header->ackRequest << ACK_REQUEST_BIT) |
+	                        ((uint16_t)panCompression << PAN_COMPRESSION_BIT) |
+	                        ((uint16_t)(header->destinationMode & 3) << DW_MAC_DESTINATION_MODE_SHIFT) |
+	                        ((uint16_t)(header->version & 3) << VERSION_SHIFT) |
+	                        ((uint16_t)(header->sourceMode & 3) << SOURCE_MODE_SHIFT);
+	buffer[0] = (uint8_t)frameControl;
+	buffer[1] = (uint8_t)(frameControl >> 8);
+	buffer[2] = header->sequence;
+	size_t i = 3;
+
+	if(destinationLength != 0) {
+		writeAddress(&buffer[i], header->destinationPan, 2);
+		writeAddress(&buffer[i + 2], header->destination, destinationLength);
+		i += 2 + destinationLength;
+	}
+	if(sourceLength != 0) {
+		if(!panCompression) {
+			writeAddress(&buffer[i], header->sourcePan, 2);
+			i += 2;
+		}
+		writeAddress(&buffer[i], header->source, sourceLength);
+		i += sourceLength;
+	}
+	return i;
+}
+
+size_t dwMacDecode(const uint8_t *buffer, size_t length, dwMacHeader_t *header) {
+	if(length < 3) {
+		return 0;
+	}
+	uint16_t frameControl = buffer[0] | ((uint16_t)buffer[1] << 8);
+	uint8_t destinationMode = (frameControl >> DW_MAC_DESTINATION_MODE_SHIFT) & 3;
+	uint8_t sourceMode = (frameControl >> SOURCE_MODE_SHIFT) & 3;
+	if((frameControl & (1u << SECURITY_BIT)) ||
+	   destinationMode == MODE_RESERVED || sourceMode == MODE_RESERVED) {
+		return 0;
+	}
+
+	header->type = frameControl & TYPE_MASK;
+	header->framePending = (frameControl >> FRAME_PENDING_BIT) & 1;
+	header->ackRequest = (frameControl >> ACK_REQUEST_BIT) & 1;
+	header->panCompression = (frameControl >> PAN_COMPRESSION_BIT) & 1;
+	header->version = (frameControl >> VERSION_SHIFT) & 3;
+	header->destinationMode = destinationMode;
+	header->sourceMode = sourceMode;
+	header->sequence = buffer[2];
+
+	size_t headerLength = dwMacHeaderLength(header);
+	if(length < headerLength) {
+		return 0;
+	}
+
+	uint8_t destinationLength = ADDRESS_LENGTH[destinationMode];
+	uint8_t sourceLength = ADDRESS_LENGTH[sourceMode];
+	size_t i = 3;
+	header->destinationPan = 0;
+	header->destination = 0;
+	if(destinationLength != 0) {
+		header->destinationPan = (uint16_t)readAddress(&buffer[i], 2);
+		header->destination = readAddress(&buffer[i + 2], destinationLength);
+		i += 2 + destinationLength;
+	}
+	header->sourcePan = header->destinationPan;
+	header->source = 0;
+	if(sourceLength != 0) {
+		if(hasSourcePan(destinationMode, sourceMode, header->panCompression)) {
+			header->sourcePan = (uint16_t)readAddress(&buffer[i], 2);
+			i += 2;
+		}
+		header->source = readAddress(&buffer[i], sourceLength);
+	}
+	return headerLength;
+}
@@ -0,0 +1,224 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "libdw1000Multilat.h"
+
+#ifdef DW_MULTILAT_THREADS
+#include <pthread.h>
+#endif
+
+#define B DW_MULTILAT_BLOCK
+// Keeps the normal equations solvable when the geometry is poor
+#define DAMPING 1e-6f
+#define MIN_RANGES 4
+
+typedef struct block_s {
+	float x[B], y[B], z[B];
+	// Normal equations, the matrix is symmetric
+	float a00[B], a01[B], a02[B], a11[B], a12[B], a22[B];
+	float b0[B], b1[B], b2[B];
+	float squares[B];
+	int ranges[B];
+} block_t;
+
+// Accumulates the normal equations of the ranges to one anchor
+static void accumulate(block_t *k, const float *tof, float ax, float ay, float az, int n) {
+	for(int t = 0; t < n; t++) {
+		float dx = k->x[t] - ax;
+		float dy = k->y[t] - ay;
+		float dz = k->z[t] - az;
+		float d = sqrtf(dx * dx + dy * dy + dz * dz);
+		// Missing range, or tag on the anchor: no contribution
+		float w = (tof[t] > 0.0f && d > 0.0f) ? 1.0f : 0.0f;
+		float inv = w / (d + (1.0f - w));
+		float ux = dx * inv;
+		float uy = dy * inv;
+		float uz = dz * inv;
+		float r = (tof[t] * DISTANCE_OF_RADIO - d) * w;
+
+		k->a00[t] += ux * ux;
+		k->a01[t] += ux * uy;
+		k->a02[t] += ux * uz;
+		k->a11[t] += uy * uy;
+		k->a12[t] += uy * uz;
+		k->a22[t] += uz * uz;
+		k->b0[t] += ux * r;
+		k->b1[t] += uy * r;
+		k->b2[t] += uz * r;
+		k->squares[t] += r * r;
+	}
+}
+
+// Solves the normal equations of each tag (Cramer's rule) and updates the
+// positions. Returns the number of tags that have not converged yet.
+static int update(block_t *k, int n) {
+	int moving = 0;
+	for(int t = 0; t < n; t++) {
+		float a00 = k->a00[t] + DAMPING;
+		float a11 = k->a11[t] + DAMPING;
+		float a22 = k->a22[t] + DAMPING;
+		float a01 = k->a01[t];
+		float a02 = k->a02[t];
+		float a12 = k->a12[t];
+		float c00 = a11 * a22 - a12 * a12;
+		float c01 = a02 * a12 - a01 * a22;
+		float c02 = a01 * a12 - a02 * a11;
+		float c11 = a00 * a22 - a02 * a02;
+		float c12 = a01 * a02 - a00 * a12;
+		float c22 = a00 * a11 - a01 * a01;
+		float det = a00 * c00 + a01 * c01 + a02 * c02;
+		// No update for the tags that cannot be solved, without branches
+		bool solvable = (k->ranges[t] >= MIN_RANGES) & (det > 0.0f);
+		float inv = 1.0f / (solvable ? det : 1.0f);
+		inv = solvable ? inv : 0.0f;
+		float dx = (c00 * k->b0[t] + c01 * k->b1[t] + c02 * k->b2[t]) * inv;
+		float dy = (c01 * k->b0[t] + c11 * k->b1[t] + c12 * k->b2[t]) * inv;
+		float dz = (c02 * k->b0[t] + c12 * k->b1[t] + c22 * k->b2[t]) * inv;
+		k->x[t] += dx;
+		k->y[t] += dy;
+		k->z[t] += dz;
+		moving += (fabsf(dx) + fabsf(dy) + fabsf(dz)) >= DW_MULTILAT_TOLERANCE;
+	}
+	return moving;
+}
+
+static void clear(block_t *k, int n) {
+	for(int t = 0; t < n; t++) {
+		k->a00[t] = k->a01[t] = k->a02[t] = k->a11[t] = k->a12[t] = k->a22[t] = 0.0f;
+		k->b0[t] = k->b1[t] = k->b2[t] = 0.0f;
+		k->squares[t] = 0.0f;
+	}
+}
+
+static void solveBlock(const dwMultilatAnchors_t *anchors, dwMultilatBatch_t *batch, int first, int n) {
+	block_t k;
+	// Start position of the new tags
+	float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+	for(int a = 0; a < anchors->count; a++) {
+		cx += anchors->x[a];
+		cy += anchors->y[a];
+		cz += anchors->z[a];
+	}
+	cx /= anchors->count;
+	cy /= anchors->count;
+	// Off the plane of the anchors, the z gradient is null in that plane
+	cz = cz / anchors->count + DW_MULTILAT_START_HEIGHT;
+
+	for(int t = 0; t < n; t++) {
+		int i = first + t;
+		bool known = !isnan(batch->x[i]);
+		k.x[t] = known ? batch->x[i] : cx;
+		k.y[t] = known ? batch->y[i] : cy;
+		k.z[t] = known ? batch->z[i] : cz;
+		k.ranges[t] = 0;
+	}
+	for(int a = 0; a < anchors->count; a++) {
+		const float *tof = &batch->tof[a * batch->stride + first];
+		for(int t = 0; t < n; t++) {
+			k.ranges[t] += tof[t] > 0.0f;
+		}
+	}
+
+	for(int i = 0; i < DW_MULTILAT_ITERATIONS; i++) {
+		clear(&k, n);
+		for(int a = 0; a < anchors->count; a++) {
+			accumulate(&k, &batch->tof[a * batch->stride + first], anchors->x[a], anchors->y[a], anchors->z[a], n);
+		}
+		if(update(&k, n) == 0) {
+			break;
+		}
+	}
+
+	// Residuals of the final positions
+	clear(&k, n);
+	for(int a = 0; a < anchors->count; a++) {
+		accumulate(&k, &batch->tof[a * batch->stride + first], anchors->x[a], anchors->y[a], anchors->z[a], n);
+	}
+
+	for(int t = 0; t < n; t++) {
+		int i = first + t;
+		bool solved = k.ranges[t] >= MIN_RANGES;
+		if(solved) {
+			batch->x[i] = k.x[t];
+			batch->y[i] = k.y[t];
+			batch->z[i] = k.z[t];
+		}
+		if(batch->residual) {
+			batch->residual[i] = solved ? sqrtf(k.squares[t] / k.ranges[t]) : NAN;
+		}
+	}
+}
+
+static void solveBlocks(const dwMultilatAnchors_t *anchors, dwMultilatBatch_t *batch, int firstBlock, int step) {
+	for(int first = firstBlock * B; first < batch->tagCount; first += step * B) {
+		int n = batch->tagCount - first;
+		solveBlock(anchors, batch, first, n < B ? n : B);
+	}
+}
+
+#ifdef DW_MULTILAT_THREADS
+typedef struct worker_s {
+	pthread_t thread;
+	const dwMultilatAnchors_t *anchors;
+	dwMultilatBatch_t *batch;
+	int firstBlock;
+} worker_t;
+
+static void *work(void *arg) {
+	worker_t *worker = arg;
+	solveBlocks(worker->anchors, worker->batch, worker->firstBlock, DW_MULTILAT_THREADS);
+	return NULL;
+}
+
+void dwMultilatSolve(const dwMultilatAnchors_t *anchors, dwMultilatBatch_t *batch) {
+	if(anchors->count == 0) {
+		return;
+	}
+	// Blocks are interleaved between the threads, the caller solves its own
+	// share and the share of the threads that could not be created
+	worker_t workers[DW_MULTILAT_THREADS];
+	bool started[DW_MULTILAT_THREADS] = {false};
+	for(int i = 1; i < DW_MULTILAT_THREADS && i * B < batch->tagCount; i++) {
+		workers[i] = (worker_t){.anchors = anchors, .batch = batch, .firstBlock = i};
+		started[i] = pthread_create(&workers[i].thread, NULL, work, &workers[i]) == 0;
+	}
+	solveBlocks(anchors, batch, 0, DW_MULTILAT_THREADS);
+	for(int i = 1; i < DW_MULTILAT_THREADS; i++) {
+		if(!started[i]) {
+			solveBlocks(anchors, batch, i, DW_MULTILAT_THREADS);
+		}
+	}
+	for(int i = 1; i < DW_MULTILAT_THREADS; i++) {
+		if(started[i]) {
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+}
+#else
+void dwMultilatSolve(const dwMultilatAnchors_t *anchors, dwMultilatBatch_t *batch) {
+	if(anchors->count == 0) {
+		return;
+	}
+	solveBlocks(anchors, batch, 0, 1);
+}
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libdw1000Poll.h"
+#include "libdw1000.h"
+
+static bool poll(dwDevice_t* dev, unsigned int initialWait, unsigned int timeoutUs) {
+	unsigned int waited = initialWait < timeoutUs ? initialWait : timeoutUs;
+	unsigned int interval = DW_POLL_MIN_INTERVAL_US;
+
+	if(waited > 0) {
+		DW_OPS_DELAYUS(dev, waited);
+	}
+
+	while(true) {
+		// One status read per poll, the events are handled directly
+		dwHandleInterrupt(dev);
+		if(dev->sysstatus & dev->sysmask) {
+			return true;
+		}
+		if(waited >= timeoutUs) {
+			return false;
+		}
+
+		if(interval > timeoutUs - waited) {
+			interval = timeoutUs - waited;
+		}
+		DW_OPS_DELAYUS(dev, interval);
+		waited += interval;
+		interval *= 2;
+		if(interval > DW_POLL_MAX_INTERVAL_US) {
+			interval = DW_POLL_MAX_INTERVAL_US;
+		}
+	}
+}
+
+bool dwPollTransmit(dwDevice_t* dev, unsigned int timeoutUs) {
+	unsigned int length = (((unsigned int)dev->txfctrl[1] << 8) | dev->txfctrl[0]) & 0x03FF;
+	return poll(dev, dwGetFrameAirtimeUs(dev, length), timeoutUs);
+}
+
+bool dwPollReceive(dwDevice_t* dev, unsigned int expectedLength, unsigned int timeoutUs) {
+	if(dev->frameCheck) {
+		expectedLength += 2;
+	}
+	return poll(dev, dwGetFrameAirtimeUs(dev, expectedLength), timeoutUs);
+}
@@ -0,0 +1,164 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include "libdw1000RangeFilter.h"
+
+#if (DW_RANGE_FILTER_WINDOW % 2) == 0
+#error "DW_RANGE_FILTER_WINDOW must be odd"
+#endif
+
+#define W DW_RANGE_FILTER_WINDOW
+#define MEDIAN (W / 2)
+// Median absolute deviation to standard deviation, for a normal distribution
+#define MAD_SCALE 1.4826f
+// Initial velocity variance of the Kalman filter, (m/s)^2
+#define INITIAL_VELOCITY_VARIANCE 1.0f
+
+void dwRangeFilterInit(dwRangeFilter_t *filter) {
+	filter->maxPowerDifference = 10.0f;
+	filter->outlierThreshold = 3.0f;
+	filter->minDeviation = 0.1f;
+	filter->kalman = false;
+	filter->processNoise = 1.0f;
+	filter->measurementNoise = 0.01f;
+	dwRangeFilterReset(filter);
+}
+
+void dwRangeFilterReset(dwRangeFilter_t *filter) {
+	filter->head = 0;
+	filter->count = 0;
+	filter->valid = false;
+	filter->range = 0.0f;
+	filter->velocity = 0.0f;
+}
+
+// Replaces 'removed' by 'added' in the sorted window, without sorting it
+static void replaceSorted(float sorted[], int count, float removed, float added) {
+	int i = count;
+	if(count == W) {
+		i = 0;
+		while(sorted[i] != removed) {
+			i++;
+		}
+		for(; i < W - 1; i++) {
+			sorted[i] = sorted[i + 1];
+		}
+	}
+	while(i > 0 && sorted[i - 1] > added) {
+		sorted[i] = sorted[i - 1];
+		i--;
+	}
+	sorted[i] = added;
+}
+
+static void push(dwRangeFilter_t *filter, float range) {
+	float removed = filter->window[filter->head];
+	replaceSorted(filter->sorted, filter->count, removed, range);
+	filter->window[filter->head] = range;
+	filter->head = (filter->head + 1) % W;
+	if(filter->count < W) {
+		filter->count++;
+	}
+}
+
+// Median absolute deviation of the full window. The deviations of the sorted
+// values grow from the median outwards, they are merged from both sides.
+static float medianAbsoluteDeviation(const float sorted[]) {
+	float median = sorted[MEDIAN];
+	int low = MEDIAN - 1;
+	int high = MEDIAN + 1;
+	float deviation = 0.0f;
+	for(int i = 0; i < MEDIAN; i++) {
+		float lowDeviation = median - sorted[low];
+		float highDeviation = sorted[high] - median;
+		if(lowDeviation < highDeviation) {
+			deviation = lowDeviation;
+			low--;
+		} else {
+			deviation = highDeviation;
+			high++;
+		}
+	}
+	return deviation;
+}
+
+static void kalmanUpdate(dwRangeFilter_t *filter, float range, float time) {
+	float *p = filter->covariance;
+	if(!filter->valid) {
+		filter->range = range;
+		filter->velocity = 0.0f;
+		p[0] = filter->measurementNoise;
+		p[1] = 0.0f;
+		p[2] = INITIAL_VELOCITY_VARIANCE;
+		return;
+	}
+
+	// Prediction
+	float dt = time - filter->time;
+	if(dt > 0.0f) {
+		float q = filter->processNoise;
+		float dt2 = dt * dt;
+		filter->range += filter->velocity * dt;
+		p[0] += dt * (2.0f * p[1] + dt * p[2]) + q * dt2 * dt2 / 4.0f;
+		p[1] += dt * p[2] + q * dt2 * dt / 2.0f;
+		p[2] += q * dt2;
+	}
+
+	// Correction
+	float innovation = range - filter->range;
+	float s = p[0] + filter->measurementNoise;
+	float k0 = p[0] / s;
+	float k1 = p[1] / s;
+	filter->range += k0 * innovation;
+	filter->velocity += k1 * innovation;
+	p[2] -= k1 * p[1];
+	p[1] -= k0 * p[1];
+	p[0] -= k0 * p[0];
+}
+
+bool dwRangeFilterUpdate(dwRangeFilter_t *filter, float range, float time, float powerDifference) {
+	if(!isfinite(range) || powerDifference > filter->maxPowerDifference) {
+		return false;
+	}
+
+	// Outliers are kept in the window, so that the median follows a real jump
+	push(filter, range);
+	float median = filter->sorted[filter->count / 2];
+	if(filter->count == W) {
+		float threshold = filter->outlierThreshold * MAD_SCALE * medianAbsoluteDeviation(filter->sorted);
+		if(threshold < filter->minDeviation) {
+			threshold = filter->minDeviation;
+		}
+		if(fabsf(range - median) > threshold) {
+			return false;
+		}
+	}
+
+	if(filter->kalman) {
+		kalmanUpdate(filter, range, time);
+	} else {
+		filter->range = median;
+	}
+	filter->time = time;
+	filter->valid = true;
+	return true;
+}
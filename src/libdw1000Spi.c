@@ -20,31 +20,18 @@
 
 
 #include "libdw1000Spi.h"
+#include "libdw1000SpiInline.h"
 
 
+#ifndef DW_STATIC_OPS
 void dwSpiRead(dwDevice_t *dev, uint8_t regid, uint32_t address,
                                 void* data, size_t length) {
 	uint8_t header[3];
- 	size_t headerLength=1;
+	size_t headerLength = dwSpiHeader(header, regid, address, false);
 
-	header[0] = regid & 0x3f;
-
-	if (address != 0) {
-		header[0] |= 0x40;
-
-		header[1] = address & 0x7f;
-		address >>= 7;
-		headerLength = 2;
-
-		if (address != 0) {
-			header[1] |= 0x80;
-			header[2] = address & 0xff;
-			headerLength = 3;
-		}
-	}
-
-	dev->ops->spiRead(dev, header, headerLength, data, length);
+	DW_OPS_SPI_READ(dev, header, headerLength, data, length);
 }
+#endif
 
 uint16_t dwSpiRead16(dwDevice_t *dev, uint8_t regid, uint32_t address) {
 	uint16_t data;
@@ -58,30 +45,27 @@ uint32_t dwSpiRead32(dwDevice_t *dev, uint8_t regid, uint32_t address) {
 	return data;
 }
 
+#ifndef DW_STATIC_OPS
 void dwSpiWrite(dwDevice_t *dev, uint8_t regid, uint32_t address,
                                  const void* data, size_t length) {
 	uint8_t header[3];
-	size_t headerLength=1;
+	size_t headerLength = dwSpiHeader(header, regid, address, true);
 
-	header[0] = regid & 0x3f;
-	header[0] |= 0x80;
-
-	if (address != 0) {
-		header[0] |= 0x40;
-
-		header[1] = address & 0x7f;
-		address >>= 7;
-		headerLength = 2;
+	DW_OPS_SPI_WRITE(dev, header, headerLength, data, length);
+}
+#endif
 
-		if (address != 0) {
-			header[1] |= 0x80;
-			header[2] = address & 0xff;
-			headerLength = 3;
-		}
-	}
+#ifndef DW_STATIC_OPS
+void dwSpiReadHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                      void* data, size_t length) {
+	DW_OPS_SPI_READ(dev, header->bytes, header->length, data, length);
+}
 
-	dev->ops->spiWrite(dev, header, headerLength, data, length);
+void dwSpiWriteHeader(dwDevice_t *dev, const dwSpiHeader_t *header,
+                                       const void* data, size_t length) {
+	DW_OPS_SPI_WRITE(dev, header->bytes, header->length, data, length);
 }
+#endif
 
 void dwSpiWrite8(dwDevice_t *dev, uint8_t regid, uint32_t address,
                                    uint8_t data) {
@@ -0,0 +1,94 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000TagTable.h"
+#include "libdw1000Hash.h"
+
+#if (DW_TAG_TABLE_SIZE & (DW_TAG_TABLE_SIZE - 1)) != 0
+#error "DW_TAG_TABLE_SIZE must be a power of two"
+#endif
+
+void dwTagTableInit(dwTagTable_t *table) {
+	for(int i = 0; i < DW_TAG_TABLE_SIZE; i++) {
+		table->address[i] = DW_HASH_EMPTY;
+	}
+	table->count = 0;
+}
+
+int dwTagTableFind(const dwTagTable_t *table, uint64_t address) {
+	unsigned int i = dwHashProbe(table->address, DW_TAG_TABLE_SIZE, address);
+	if(table->address[i] == DW_HASH_EMPTY) {
+		return -1;
+	}
+	return (int)i;
+}
+
+int dwTagTableInsert(dwTagTable_t *table, uint64_t address) {
+	// The probe would stop on the first empty slot and return it as a match
+	if(address == DW_HASH_EMPTY) {
+		return -1;
+	}
+
+	unsigned int i = dwHashProbe(table->address, DW_TAG_TABLE_SIZE, address);
+	if(table->address[i] == address) {
+		return (int)i;
+	}
+
+	if(table->count >= DW_TAG_TABLE_CAPACITY) {
+		return -1;
+	}
+	table->address[i] = address;
+	table->sequence[i] = 0;
+	table->pollRx[i] = 0;
+	table->answerTx[i] = 0;
+	table->finalRx[i] = 0;
+	table->range[i] = 0;
+	dwRangeFilterInit(&table->filter[i]);
+	table->count++;
+	return (int)i;
+}
+
+static void move(dwTagTable_t *table, unsigned int to, unsigned int from) {
+	table->address[to] = table->address[from];
+	table->sequence[to] = table->sequence[from];
+	table->pollRx[to] = table->pollRx[from];
+	table->answerTx[to] = table->answerTx[from];
+	table->finalRx[to] = table->finalRx[from];
+	table->range[to] = table->range[from];
+	table->filter[to] = table->filter[from];
+}
+
+void dwTagTableRemove(dwTagTable_t *table, int index) {
+	unsigned int hole = (unsigned int)index;
+	unsigned int i;
+
+	if(index < 0 || index >= DW_TAG_TABLE_SIZE || table->address[hole] == DW_HASH_EMPTY) {
+		return;
+	}
+
+	while((i = dwHashShift(table->address, DW_TAG_TABLE_SIZE, hole)) != DW_TAG_TABLE_SIZE) {
+		move(table, hole, i);
+		hole = i;
+	}
+	table->address[hole] = DW_HASH_EMPTY;
+	table->count--;
+}
@@ -0,0 +1,210 @@
+/*
+ * Driver for decaWave DW1000 802.15.4 UWB radio chip.
+ *
+ * Copyright (c) 2016 Bitcraze AB
+ * Converted to C from  the Decawave DW1000 library for arduino.
+ * which is Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "libdw1000Tdma.h"
+#include "libdw1000.h"
+
+// RX_FWTO counts in units of 512/499.2MHz, 65536 device time units
+#define RX_TIMEOUT_UNIT_SHIFT 16
+
+static void armSlot(dwTdma_t *tdma);
+
+uint8_t dwTdmaNextSlot(const dwTdmaSuperframe_t *superframe, uint8_t slot,
+                       unsigned int *distance) {
+	uint8_t next = slot;
+	for(unsigned int i = 1; i <= superframe->slotCount; i++) {
+		next = next + 1 < superframe->slotCount ? next + 1 : 0;
+		if(superframe->slots[next].type != dwTdmaSlotIdle) {
+			*distance = i;
+			return next;
+		}
+	}
+	*distance = superframe->slotCount;
+	return slot;
+}
+
+dwTime_t dwTdmaMinimumSlotLength(dwDevice_t *dev, unsigned int length, dwTime_t guard) {
+	dwTime_t slotLength = dwGetFrameAirtime(dev, length);
+	slotLength.full += 2 * guard.full;
+	return slotLength;
+}
+
+static void advance(dwTdma_t *tdma) {
+	const dwTdmaSuperframe_t *superframe = tdma->superframe;
+	unsigned int distance;
+
+	tdma->slot = dwTdmaNextSlot(superframe, tdma->slot, &distance);
+	tdma->slotStart.full = (tdma->slotStart.full + distance * superframe->slotLength.full) & TIME_MASK;
+}
+
+static bool loadTx(dwTdma_t *tdma, uint8_t slot) {
+	uint8_t data[DW_TDMA_MAX_FRAME_LENGTH];
+	unsigned int length = tdma->prepareTx(tdma, slot, data);
+	if(length == 0) {
+		return false;
+	}
+	if(length > DW_TDMA_MAX_FRAME_LENGTH) {
+		length = DW_TDMA_MAX_FRAME_LENGTH;
+	}
+	dwSetData(tdma->dev, data, length);
+	tdma->txLoaded = true;
+	return true;
+}
+
+static bool armTx(dwTdma_t *tdma) {
+	dwDevice_t *dev = tdma->dev;
+
+	dwNewTransmit(dev);
+	if(!tdma->txLoaded && !loadTx(tdma, tdma->slot)) {
+		return false;
+	}
+	tdma->txLoaded = false;
+	dwSetTxRxTime(dev, tdma->slotStart);
+	if(dwStartTransmit(dev) != DW_ERROR_OK) {
+		tdma->missedSlots++;
+		return false;
+	}
+	return true;
+}
+
+static bool armRx(dwTdma_t *tdma) {
+	dwDevice_t *dev = tdma->dev;
+	const dwTdmaSuperframe_t *superframe = tdma->superframe;
+
+	dwTime_t open;
+	open.full = (tdma->slotStart.full - dwGetPreambleDuration(dev).full -
+	             superframe->guard.full) & TIME_MASK;
+	dwNewReceive(dev);
+	dwSetTxRxTime(dev, open);
+	if(dwStartReceive(dev) != DW_ERROR_OK) {
+		tdma->missedSlots++;
+		return false;
+	}
+
+	// Queue the frame of a following TX slot while the receiver waits
+	unsigned int distance;
+	uint8_t next = dwTdmaNextSlot(superframe, tdma->slot, &distance);
+	if(superframe->slots[next].type == dwTdmaSlotTx && !tdma->txLoaded) {
+		loadTx(tdma, next);
+	}
+	return true;
+}
+
+static void armSlot(dwTdma_t *tdma) {
+	// An idle slot, a TX slot left idle or a slot programmed too late is skipped
+	for(unsigned int i = 0; i < tdma->superframe->slotCount; i++) {
+		dwTdmaSlotType_t type = tdma->superframe->slots[tdma->slot].type;
+		bool armed = false;
+		if(type == dwTdmaSlotTx) {
+			armed = armTx(tdma);
+		} else if(type == dwTdmaSlotRx) {
+			armed = armRx(tdma);
+		}
+		if(armed) {
+			return;
+		}
+		advance(tdma);
+	}
+	// Nothing to send and nothing to receive in a whole superframe
+	dwIdle(tdma->dev);
+	tdma->running = false;
+}
+
+static void nextSlot(dwDevice_t *dev) {
+	dwTdma_t *tdma = dwGetUserdata(dev);
+	if(!tdma->running) {
+		return;
+	}
+	advance(tdma);
+	armSlot(tdma);
+}
+
+static void frameReceived(dwDevice_t *dev) {
+	dwTdma_t *tdma = dwGetUserdata(dev);
+	if(!tdma->running) {
+		return;
+	}
+
+	const dwTdmaSuperframe_t *superframe = tdma->superframe;
+	if(superframe->slots[tdma->slot].owner == superframe->syncOwner) {
+		// The frame was sent at the slot start of the sync owner
+		dwTime_t rxTime;
+		dwGetRawReceiveTimestamp(dev, &rxTime);
+		tdma->slotStart.full = (rxTime.full - dev->antennaDelay.full) & TIME_MASK;
+	}
+	if(tdma->received) {
+		tdma->received(tdma, tdma->slot);
+	}
+	nextSlot(dev);
+}
+
+void dwTdmaInit(dwTdma_t *tdma, dwDevice_t *dev, const dwTdmaSuperframe_t *superframe,
+                dwTdmaPrepareTx_t prepareTx, dwTdmaReceived_t received) {
+	tdma->dev = dev;
+	tdma->superframe = superframe;
+	tdma->prepareTx = prepareTx;
+	tdma->received = received;
+	tdma->userdata = NULL;
+	tdma->running = false;
+	tdma->slot = 0;
+	tdma->slotStart.full = 0;
+	tdma->txLoaded = false;
+	tdma->missedSlots = 0;
+}
+
+void dwTdmaStart(dwTdma_t *tdma, dwTime_t start) {
+	dwDevice_t *dev = tdma->dev;
+	const dwTdmaSuperframe_t *superframe = tdma->superframe;
+
+	dwSetUserdata(dev, tdma);
+#ifdef DW_COMPACT_DEVICE
+	memset(&tdma->handlers, 0, sizeof(tdma->handlers));
+	dwSetHandlers(dev, &tdma->handlers);
+#endif
+	dwAttachSentHandler(dev, nextSlot);
+	dwAttachReceivedHandler(dev, frameReceived);
+	dwAttachReceiveTimeoutHandler(dev, nextSlot);
+	dwAttachReceiveFailedHandler(dev, nextSlot);
+
+	// The receive window of an RX slot closes a guard before the receiver of
+	// the next slot opens
+	uint64_t window = superframe->slotLength.full - superframe->guard.full;
+	window >>= RX_TIMEOUT_UNIT_SHIFT;
+	dwSetReceiveWaitTimeout(dev, window > 0xFFFF ? 0xFFFF : (uint16_t)window);
+	dwInterruptOnReceiveTimeout(dev, true);
+	dwWriteSystemConfigurationRegister(dev);
+	dwWriteSystemEventMaskRegister(dev);
+
+	tdma->running = true;
+	tdma->slot = 0;
+	tdma->slotStart.full = start.full & TIME_MASK;
+	tdma->txLoaded = false;
+	if(superframe->slots[0].type == dwTdmaSlotIdle) {
+		advance(tdma);
+	}
+	armSlot(tdma);
+}
+
+void dwTdmaStop(dwTdma_t *tdma) {
+	tdma->running = false;
+	dwIdle(tdma->dev);
+}
@@ -32,6 +32,16 @@ static void dwSpiRead_executor(dwDevice_t* dev, uint8_t regid, uint32_t address,
 static void dwSpiRead_addExpectation(dwSpiReadExpectation_t* readExpectation);
 #define dwSpiWrite_ExpectAndVerify(dev, regid, address, data) dwSpiWrite_ExpectWithArray(dev, 1, regid, address, data, sizeof(data), sizeof(data))
 
+static void dwSpiReadHeader_forwarder(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls);
+static void dwSpiWriteHeader_forwarder(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls);
+
+void setUp() {
+  // Accesses through precomputed headers are verified as regular dwSpiRead()
+  // and dwSpiWrite() calls
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_forwarder);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_forwarder);
+}
+
 
 
 // TODO krri dwConfigure()
@@ -224,6 +234,568 @@ void testGetReceivePowerAt64MHzLowPower() {
   verifyGetReceivePower(cirPwr, rxFrameInfo, TX_PULSE_FREQ_64MHZ, -81.632904);
 }
 
+void testThatPowersFromDiagnosticsMatchPowersReadFromDevice() {
+  // Fixture
+  dwRxDiagnostics_t diag = {.fpAmpl1 = 0x6251, .fpAmpl2 = 0x8473, .fpAmpl3 = 0xa695, .cirPwr = 0x7e81, .rxPacc = 0xb00};
+  dev.pulseFrequency = TX_PULSE_FREQ_16MHZ;
+
+  // Test
+  float actualFirstPath = dwDiagnosticsFirstPathPower(&dev, &diag);
+  float actualReceive = dwDiagnosticsReceivePower(&dev, &diag);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.00003, -85.324951, actualFirstPath);
+  TEST_ASSERT_FLOAT_WITHIN(0.00003, -82.946953, actualReceive);
+}
+
+static void verifyNlosProbability(uint16_t fpAmpl, uint16_t cirPwr, uint16_t stdNoise, float expected) {
+  // Fixture
+  dwRxDiagnostics_t diag = {.fpAmpl1 = fpAmpl, .fpAmpl2 = fpAmpl, .fpAmpl3 = fpAmpl, .cirPwr = cirPwr, .rxPacc = 0xb00, .stdNoise = stdNoise};
+  dev.pulseFrequency = TX_PULSE_FREQ_16MHZ;
+
+  // Test
+  float actual = dwDiagnosticsNlosProbability(&dev, &diag);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.001, expected, actual);
+}
+
+void testThatStrongFirstPathIsLineOfSight() {
+  // 3.7dB between receive and first path power, quality 192
+  verifyNlosProbability(0x3000, 0x2000, 0x40, 0.0f);
+}
+
+void testThatWeakFirstPathIsNonLineOfSight() {
+  // 16.8dB between receive and first path power
+  verifyNlosProbability(0x2000, 0x7e81, 0x40, 1.0f);
+}
+
+void testThatNlosProbabilityIsInterpolatedBetweenThresholds() {
+  // 7.27dB between receive and first path power
+  verifyNlosProbability(0x2000, 0x2000, 0x40, 0.3175f);
+}
+
+void testThatLowReceiveQualityIsNonLineOfSight() {
+  // 3.7dB between receive and first path power, quality 2
+  verifyNlosProbability(0x3000, 0x2000, 0x1800, 1.0f);
+}
+
+
+static void verifyGetClockOffsetPpm(uint8_t* carrierInt, uint8_t channel, uint8_t dataRate, float expected);
+
+void testGetClockOffsetPpmWithNegativeCarrierIntegrator() {
+  // Fixture
+  uint8_t carrierInt[LEN_DRX_CAR_INT] = {0x18, 0xfc, 0x1f};
+
+  // Test
+  // Assert
+  verifyGetClockOffsetPpm(carrierInt, CHANNEL_5, TRX_RATE_6800KBPS, 0.573122);
+}
+
+void testGetClockOffsetPpmWithPositiveCarrierIntegratorAt110kbps() {
+  // Fixture
+  uint8_t carrierInt[LEN_DRX_CAR_INT] = {0x10, 0x27, 0x00};
+
+  // Test
+  // Assert
+  verifyGetClockOffsetPpm(carrierInt, CHANNEL_2, TRX_RATE_110KBPS, -1.164153);
+}
+
+void testGetClockOffsetPpmUsesOnly21BitsOfCarrierIntegrator() {
+  // Fixture
+  uint8_t carrierInt[LEN_DRX_CAR_INT] = {0x00, 0x00, 0xf0};
+
+  // Test
+  // Assert
+  verifyGetClockOffsetPpm(carrierInt, CHANNEL_2, TRX_RATE_110KBPS, 122.070312);
+}
+
+
+void testThatSetDelayFromSchedulesRelativeToReference() {
+  // Fixture
+  dev.deviceMode = TX_MODE;
+  dev.antennaDelay.full = 0x4000;
+  dwTime_t reference = {.full = 0xab0000fffffff123};
+  dwTime_t delay = {.full = 0x10000};
+
+  uint8_t dxTime[LEN_DX_TIME] = {0x00, 0xf0, 0x00, 0x00, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, DX_TIME, NO_SUB, dxTime);
+
+  // Test
+  dwTime_t actual = dwSetDelayFrom(&dev, &reference, &delay);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(0x13000, actual.full);
+}
+
+
+void testThatLateDelayedTransmitIsAborted() {
+  // Fixture
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+
+  dev.frameCheck = true;
+  dev.permanentReceive = false;
+  dev.wait4resp = false;
+  dev.deviceMode = TX_MODE;
+  memset(dev.txfctrl, 0, LEN_TX_FCTRL);
+  dev.sysctrl = 1 << TXDLYS_BIT;
+
+  uint8_t txfctrl[LEN_TX_FCTRL] = {0};
+  dwSpiWrite_ExpectAndVerify(&dev, TX_FCTRL, NO_SUB, txfctrl);
+  uint8_t start[LEN_SYS_CTRL] = {0x06, 0x00, 0x00, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_CTRL, NO_SUB, start);
+
+  uint8_t status[] = {0xff, 0x00};
+  dwSpiReadExpectation_t readExpectation = {&dev, SYS_STATUS, 3, status, sizeof(status), NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+
+  uint8_t idle[LEN_SYS_CTRL] = {0x40, 0x00, 0x00, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_CTRL, NO_SUB, idle);
+  uint8_t clear[] = {0x08, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_STATUS, 3, clear);
+
+  // Test
+  int actual = dwStartTransmit(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_LATE_SCHEDULE, actual);
+  TEST_ASSERT_EQUAL(IDLE_MODE, dev.deviceMode);
+}
+
+
+void testThatLateDelayedReceiveIsAborted() {
+  // Fixture
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+
+  dev.frameCheck = true;
+  dev.deviceMode = RX_MODE;
+  dev.sysctrl = 1 << RXDLYS_BIT;
+
+  uint8_t start[LEN_SYS_CTRL] = {0x00, 0x03, 0x00, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_CTRL, NO_SUB, start);
+
+  uint8_t status[] = {0xff, 0xff};
+  dwSpiReadExpectation_t readExpectation = {&dev, SYS_STATUS, 3, status, sizeof(status), NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+
+  uint8_t idle[LEN_SYS_CTRL] = {0x40, 0x00, 0x00, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_CTRL, NO_SUB, idle);
+  uint8_t clear[] = {0x08, 0x00};
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_STATUS, 3, clear);
+
+  // Test
+  int actual = dwStartReceive(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_LATE_SCHEDULE, actual);
+  TEST_ASSERT_EQUAL(IDLE_MODE, dev.deviceMode);
+}
+
+
+static int lockDepth;
+static int lockedWrites;
+
+static void dwSpiWrite_ignore(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls);
+
+static void countLock(dwDevice_t* dev) {
+  lockDepth++;
+}
+
+static void countUnlock(dwDevice_t* dev) {
+  lockDepth--;
+}
+
+static void dwSpiWrite_countLocked(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+  if (lockDepth > 0) {
+    lockedWrites++;
+  }
+}
+
+void testThatTransmitSequenceIsRunWithDeviceLocked() {
+  // Fixture
+  dwOps_t lockingOps = ops;
+  lockingOps.lock = countLock;
+  lockingOps.unlock = countUnlock;
+  dwDevice_t lockedDev = {.ops = &lockingOps};
+  lockDepth = 0;
+  lockedWrites = 0;
+  lockedDev.permanentReceive = true;
+  dwSpiWrite_StubWithCallback(dwSpiWrite_countLocked);
+
+  // Test
+  dwNewTransmit(&lockedDev);
+  int actual = dwStartTransmit(&lockedDev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_OK, actual);
+  TEST_ASSERT_EQUAL(RX_MODE, lockedDev.deviceMode);
+  TEST_ASSERT_EQUAL(0, lockDepth);
+  // idle, clear status, frame control, start and receiver enable
+  TEST_ASSERT_EQUAL(5, lockedWrites);
+}
+
+static int minimumWriteDepth;
+
+static void dwSpiWrite_recordDepth(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+  if (lockDepth < minimumWriteDepth) {
+    minimumWriteDepth = lockDepth;
+  }
+}
+
+void testThatLockNestsAroundTransmitSequence() {
+  // Fixture
+  dwOps_t lockingOps = ops;
+  lockingOps.lock = countLock;
+  lockingOps.unlock = countUnlock;
+  dwDevice_t lockedDev = {.ops = &lockingOps, .frameCheck = true};
+  uint8_t data[] = {0x01, 0x02, 0x03};
+  lockDepth = 0;
+  minimumWriteDepth = 100;
+  dwSpiWrite_StubWithCallback(dwSpiWrite_recordDepth);
+
+  // Test
+  dwLock(&lockedDev);
+  dwNewTransmit(&lockedDev);
+  dwSetData(&lockedDev, data, sizeof(data));
+  int actual = dwStartTransmit(&lockedDev);
+  int depthInSequence = lockDepth;
+  dwUnlock(&lockedDev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_OK, actual);
+  // Each function locks again inside the sequence lock
+  TEST_ASSERT_EQUAL(2, minimumWriteDepth);
+  TEST_ASSERT_EQUAL(1, depthInSequence);
+  TEST_ASSERT_EQUAL(0, lockDepth);
+}
+
+static uint8_t modeAtUnlock;
+static int modeChangesWhileUnlocked;
+
+static void checkModeLock(dwDevice_t* dev) {
+  if (lockDepth == 0 && dev->deviceMode != modeAtUnlock) {
+    modeChangesWhileUnlocked++;
+  }
+  lockDepth++;
+}
+
+static void checkModeUnlock(dwDevice_t* dev) {
+  lockDepth--;
+  if (lockDepth == 0) {
+    modeAtUnlock = dev->deviceMode;
+  }
+}
+
+void testThatDeviceModeChangesOnlyWithDeviceLocked() {
+  // Fixture
+  dwOps_t lockingOps = ops;
+  lockingOps.lock = checkModeLock;
+  lockingOps.unlock = checkModeUnlock;
+  dwDevice_t lockedDev = {.ops = &lockingOps, .deviceMode = IDLE_MODE, .wait4resp = true};
+  lockDepth = 0;
+  modeAtUnlock = IDLE_MODE;
+  modeChangesWhileUnlocked = 0;
+  dwSpiWrite_StubWithCallback(dwSpiWrite_ignore);
+
+  // Test
+  dwNewTransmit(&lockedDev);
+  uint8_t transmitMode = lockedDev.deviceMode;
+  dwStartTransmit(&lockedDev);
+  uint8_t waitMode = lockedDev.deviceMode;
+  dwIdle(&lockedDev);
+  uint8_t idleMode = lockedDev.deviceMode;
+  dwNewReceive(&lockedDev);
+  dwStartReceive(&lockedDev);
+  uint8_t receiveMode = lockedDev.deviceMode;
+
+  // Assert
+  TEST_ASSERT_EQUAL(TX_MODE, transmitMode);
+  TEST_ASSERT_EQUAL(RX_MODE, waitMode);
+  TEST_ASSERT_EQUAL(IDLE_MODE, idleMode);
+  TEST_ASSERT_EQUAL(RX_MODE, receiveMode);
+  TEST_ASSERT_EQUAL(0, modeChangesWhileUnlocked);
+  TEST_ASSERT_EQUAL(receiveMode, modeAtUnlock);
+  TEST_ASSERT_EQUAL(0, lockDepth);
+}
+
+
+void verifyFrameAirtime(uint8_t dataRate, uint8_t pulseFrequency, uint8_t preambleLength, unsigned int length, uint64_t expected, unsigned int expectedUs) {
+  // Fixture
+  dev.dataRate = dataRate;
+  dev.pulseFrequency = pulseFrequency;
+  dev.preambleLength = preambleLength;
+
+  // Test
+  dwTime_t actual = dwGetFrameAirtime(&dev, length);
+  unsigned int actualUs = dwGetFrameAirtimeUs(&dev, length);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(expected, actual.full);
+  TEST_ASSERT_EQUAL_UINT(expectedUs, actualUs);
+}
+
+static const uint64_t* systemTimes;
+static int systemTimeReads;
+
+static void dwSpiRead_fakeSystemTime(dwDevice_t* dev, uint8_t regid, uint32_t address, void* data, size_t length, int cmock_num_calls) {
+  memset(data, 0, length);
+  if (regid == SYS_TIME) {
+    memcpy(data, &systemTimes[systemTimeReads++], length);
+  } else if (regid == RX_FINFO) {
+    ((uint8_t*)data)[3] = 0x40;
+  }
+}
+
+static void dwSpiWrite_ignore(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+}
+
+static uint16_t dwSpiRead16_one(dwDevice_t* dev, uint8_t regid, uint32_t address, int cmock_num_calls) {
+  return 1;
+}
+
+void testThatMeasureReplyDelayKeepsWorstCaseOverIterations() {
+  // Fixture
+  // t0, t1 and t2 of each iteration, the second one wraps
+  const uint64_t times[] = {
+    1000, 1100, 1500,
+    TIME_MASK - 149, 150, 350,
+  };
+  systemTimes = times;
+  systemTimeReads = 0;
+  dwSpiRead_StubWithCallback(dwSpiRead_fakeSystemTime);
+  dwSpiRead16_StubWithCallback(dwSpiRead16_one);
+  dwSpiWrite_StubWithCallback(dwSpiWrite_ignore);
+  dev.frameCheck = true;
+  dev.sysstatus = 0x1234;
+  uint8_t txfctrl[LEN_TX_FCTRL];
+  memcpy(txfctrl, dev.txfctrl, LEN_TX_FCTRL);
+  dwTime_t interruptLatency = {.full = 1000};
+  dwReplyDelay_t actual;
+
+  // Test
+  dwMeasureReplyDelay(&dev, 10, interruptLatency, 2, &actual);
+
+  // Assert
+  TEST_ASSERT_EQUAL(6, systemTimeReads);
+  TEST_ASSERT_EQUAL_UINT64(300, actual.spiRoundTrip.full);
+  TEST_ASSERT_EQUAL_UINT64(400, actual.driverWork.full);
+  // (1000 + 300 + 400) with 25% margin, plus the preamble and SFD
+  uint64_t expected = 2125 + dwGetPreambleDuration(&dev).full;
+  TEST_ASSERT_EQUAL_UINT64(expected, actual.recommended.full);
+  TEST_ASSERT_EQUAL_UINT64(0x1234, dev.sysstatus);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(txfctrl, dev.txfctrl, LEN_TX_FCTRL);
+}
+
+void testThatAutoAcknowledgeEnablesFrameFilter() {
+  // Fixture
+  dev.syscfg = 0;
+
+  // Test
+  dwSetAutoAcknowledge(&dev, true);
+
+  // Assert
+  TEST_ASSERT_TRUE(dev.autoAck);
+  TEST_ASSERT_EQUAL_HEX32(1ul << AUTOACK_BIT | 1ul << FFEN_BIT, dev.syscfg);
+}
+
+void testThatAutoAcknowledgeTurnaroundIsWritten() {
+  // Fixture
+  dwSpiWrite8_Expect(&dev, ACK_RESP_T, ACK_TIM_SUB, 3);
+
+  // Test
+  dwSetAutoAcknowledgeTurnaround(&dev, 3);
+
+  // Assert
+}
+
+void testFrameAirtimeAt6800kbps() {
+  verifyFrameAirtime(TRX_RATE_6800KBPS, TX_PULSE_FREQ_64MHZ, TX_PREAMBLE_LEN_128, 12, 11399168, 179);
+}
+
+void testFrameAirtimeAt110kbps() {
+  verifyFrameAirtime(TRX_RATE_110KBPS, TX_PULSE_FREQ_16MHZ, TX_PREAMBLE_LEN_2048, 127, 778436608, 12183);
+}
+
+void testFrameAirtimeAddsReedSolomonBlockEvery330Bits() {
+  // 41 bytes fit in one block, 42 bytes need a second one
+  verifyFrameAirtime(TRX_RATE_850KBPS, TX_PULSE_FREQ_16MHZ, TX_PREAMBLE_LEN_1024, 41, 92045312, 1441);
+  verifyFrameAirtime(TRX_RATE_850KBPS, TX_PULSE_FREQ_16MHZ, TX_PREAMBLE_LEN_1024, 42, 95715328, 1498);
+}
+
+
+void testThatWaitForResponseDelayIsLimitedTo20Bits() {
+  // Fixture
+  uint8_t w4rTim[LEN_W4R_TIM] = {0x56, 0x34, 0x02};
+  dwSpiWrite_ExpectAndVerify(&dev, ACK_RESP_T, W4R_TIM_SUB, w4rTim);
+
+  // Test
+  dwSetWaitForResponseDelay(&dev, 0x123456);
+
+  // Assert
+}
+
+
+static int sentHandlerCalls;
+static int receivedHandlerCalls;
+static void sentHandler(dwDevice_t* dev) { (void)dev; sentHandlerCalls++; }
+static void receivedHandler(dwDevice_t* dev) { (void)dev; receivedHandlerCalls++; }
+
+void testThatHandleInterruptAcknowledgesTxAndRxWithOneWrite() {
+  // Fixture
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+
+  dev.frameCheck = true;
+  dev.permanentReceive = false;
+  dev.autoAck = false;
+  dev.ackPending = false;
+  dev.handleError = NULL;
+  dev.handleSent = sentHandler;
+  dev.handleReceived = receivedHandler;
+  dev.handleReceiveTimestampAvailable = NULL;
+  sentHandlerCalls = 0;
+  receivedHandlerCalls = 0;
+
+  uint8_t status[LEN_SYS_STATUS] = {0x80, 0x60, 0x00, 0x00, 0x00};
+  dwSpiReadExpectation_t readExpectation = {&dev, SYS_STATUS, NO_SUB, status, sizeof(status), NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+
+  uint32_t handled = SYS_STATUS_ALL_TX | SYS_STATUS_ALL_RX_TO | SYS_STATUS_ALL_RX_ERR | SYS_STATUS_ALL_RX_GOOD;
+  uint8_t clear[sizeof(handled)];
+  memcpy(clear, &handled, sizeof(handled));
+  dwSpiWrite_ExpectAndVerify(&dev, SYS_STATUS, NO_SUB, clear);
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, sentHandlerCalls);
+  TEST_ASSERT_EQUAL(1, receivedHandlerCalls);
+}
+
+static bool rejectFrame(dwDevice_t* dev) { (void)dev; return false; }
+static int receiverEnables;
+
+static void dwSpiWrite_countReceiverEnables(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+  if (regid == SYS_CTRL && (((const uint8_t*)data)[1] & (1 << (RXENAB_BIT - 8)))) {
+    receiverEnables++;
+  }
+}
+
+static int receiverEnablesBeforeHandler;
+static void receivedHandlerCountingEnables(dwDevice_t* dev) {
+  (void)dev;
+  receivedHandlerCalls++;
+  receiverEnablesBeforeHandler = receiverEnables;
+}
+
+static void setUpAutoAckInterrupt(uint8_t* status) {
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+  dwSpiWrite_StubWithCallback(dwSpiWrite_countReceiverEnables);
+
+  dev.frameCheck = true;
+  dev.permanentReceive = true;
+  dev.wait4resp = false;
+  dev.autoAck = true;
+  dev.handleError = NULL;
+  dev.handleSent = sentHandler;
+  dev.handleReceived = receivedHandlerCountingEnables;
+  dev.handleReceiveTimestampAvailable = NULL;
+
+  static dwSpiReadExpectation_t readExpectation;
+  readExpectation = (dwSpiReadExpectation_t){&dev, SYS_STATUS, NO_SUB, status, LEN_SYS_STATUS, NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+}
+
+void testThatAcknowledgedFrameKeepsReceiverOffUntilAckIsSent() {
+  // Fixture
+  // AAT, RXDFR and RXFCG
+  uint8_t status[LEN_SYS_STATUS] = {0x08, 0x60, 0x00, 0x00, 0x00};
+  dev.ackPending = false;
+  setUpAutoAckInterrupt(status);
+  sentHandlerCalls = 0;
+  receivedHandlerCalls = 0;
+  receiverEnables = 0;
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, receivedHandlerCalls);
+  TEST_ASSERT_TRUE(dev.ackPending);
+  TEST_ASSERT_EQUAL(0, receiverEnables);
+}
+
+void testThatSentAckRestartsReceiverWithoutSentCallback() {
+  // Fixture
+  // TXFRS
+  uint8_t status[LEN_SYS_STATUS] = {0x80, 0x00, 0x00, 0x00, 0x00};
+  dev.ackPending = true;
+  setUpAutoAckInterrupt(status);
+  sentHandlerCalls = 0;
+  receivedHandlerCalls = 0;
+  receiverEnables = 0;
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, sentHandlerCalls);
+  TEST_ASSERT_EQUAL(0, receivedHandlerCalls);
+  TEST_ASSERT_FALSE(dev.ackPending);
+  TEST_ASSERT_EQUAL(1, receiverEnables);
+}
+
+void testThatFrameAndSentAckInOneInterruptRestartReceiverOnceAfterHandler() {
+  // Fixture
+  // AAT, TXFRS, RXDFR and RXFCG
+  uint8_t status[LEN_SYS_STATUS] = {0x88, 0x60, 0x00, 0x00, 0x00};
+  dev.ackPending = false;
+  setUpAutoAckInterrupt(status);
+  sentHandlerCalls = 0;
+  receivedHandlerCalls = 0;
+  receiverEnables = 0;
+  receiverEnablesBeforeHandler = -1;
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, sentHandlerCalls);
+  TEST_ASSERT_EQUAL(1, receivedHandlerCalls);
+  TEST_ASSERT_EQUAL(0, receiverEnablesBeforeHandler);
+  TEST_ASSERT_FALSE(dev.ackPending);
+  TEST_ASSERT_EQUAL(1, receiverEnables);
+}
+
+void testThatFrameRejectedByReceiveFilterIsDroppedAndReceiverRestarted() {
+  // Fixture
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+  dwSpiWrite_StubWithCallback(dwSpiWrite_countReceiverEnables);
+
+  dev.frameCheck = true;
+  dev.permanentReceive = false;
+  dev.autoAck = false;
+  dev.ackPending = false;
+  dev.handleError = NULL;
+  dev.handleReceived = receivedHandler;
+  dev.handleReceiveTimestampAvailable = NULL;
+  dwAttachReceiveFilter(&dev, rejectFrame);
+  receivedHandlerCalls = 0;
+  receiverEnables = 0;
+
+  uint8_t status[LEN_SYS_STATUS] = {0x00, 0x60, 0x00, 0x00, 0x00};
+  dwSpiReadExpectation_t readExpectation = {&dev, SYS_STATUS, NO_SUB, status, sizeof(status), NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, receivedHandlerCalls);
+  TEST_ASSERT_EQUAL(1, receiverEnables);
+  TEST_ASSERT_EQUAL(RX_MODE, dev.deviceMode);
+  dwAttachReceiveFilter(&dev, NULL);
+}
 
 
 
@@ -258,7 +830,6 @@ void testGetReceivePowerAt64MHzLowPower() {
 // TODO krri dwGetFirstPathPower()
 // TODO krri dwEnableMode()
 // TODO krri dwTune()
-// TODO krri dwHandleInterrupt()
 // TODO krri dwStrError()
 
 
@@ -295,6 +866,40 @@ static void dwSpiRead_executor(dwDevice_t* dev, uint8_t regid, uint32_t address,
   nextReadExpectation = nextReadExpectation->next;
 }
 
+// Accesses through precomputed headers are decoded and forwarded to the
+// dwSpiRead() and dwSpiWrite() mocks
+
+static void decodeHeader(const dwSpiHeader_t* header, uint8_t* regid, uint32_t* address) {
+  *regid = header->bytes[0] & 0x3f;
+  *address = 0;
+  if (header->bytes[0] & 0x40) {
+    *address = header->bytes[1] & 0x7f;
+    if (header->bytes[1] & 0x80) {
+      *address |= (uint32_t)header->bytes[2] << 7;
+    }
+  }
+}
+
+static void dwSpiReadHeader_forwarder(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  cmock_num_calls++; // Dummy line to keep compiler happy
+  uint8_t regid;
+  uint32_t address;
+
+  TEST_ASSERT_FALSE_MESSAGE(header->bytes[0] & 0x80, "write header used for read");
+  decodeHeader(header, &regid, &address);
+  dwSpiRead(dev, regid, address, data, length);
+}
+
+static void dwSpiWriteHeader_forwarder(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls) {
+  cmock_num_calls++; // Dummy line to keep compiler happy
+  uint8_t regid;
+  uint32_t address;
+
+  TEST_ASSERT_TRUE_MESSAGE(header->bytes[0] & 0x80, "read header used for write");
+  decodeHeader(header, &regid, &address);
+  dwSpiWrite(dev, regid, address, data, length);
+}
+
 /*****************************/
 
 static void verifyGdwGetFirstPathPower(uint16_t fpAmpl1, uint16_t fpAmpl2,
@@ -337,3 +942,21 @@ static void verifyGetReceivePower(uint16_t cirPwr, uint8_t* rxFrameInfo, uint8_t
   // Assert
   TEST_ASSERT_FLOAT_WITHIN(0.00003, expected, actual);
 }
+
+
+static void verifyGetClockOffsetPpm(uint8_t* carrierInt, uint8_t channel, uint8_t dataRate, float expected) {
+  // Fixture
+  dwSpiRead_StubWithCallback(dwSpiRead_executor);
+
+  dwSpiReadExpectation_t readExpectation = {&dev, DRX_TUNE, DRX_CAR_INT_SUB, carrierInt, LEN_DRX_CAR_INT, NULL};
+  dwSpiRead_addExpectation(&readExpectation);
+
+  dev.channel = channel;
+  dev.dataRate = dataRate;
+
+  // Test
+  float actual = dwGetClockOffsetPpm(&dev);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.00001, expected, actual);
+}
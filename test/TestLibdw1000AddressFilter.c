@@ -0,0 +1,175 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000AddressFilter.h"
+#include "libdw1000Blink.h"
+
+#include "mock_libdw1000Spi.h"
+
+static dwOps_t ops;
+static dwDevice_t dev;
+static dwAddressFilter_t filter;
+
+// Data frame from short address 0x5678, PAN id compression
+static uint8_t shortFrame[] = {0x41, 0x88, 0x17, 0xCA, 0xDE, 0x34, 0x12, 0x78, 0x56, 0xAA, 0xBB, 0xCC, 0xDD};
+
+static const uint8_t* rxBuffer;
+static size_t rxLength;
+static size_t readLength;
+
+static void dwSpiReadHeader_rxBuffer(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  if (header->bytes[0] == RX_FINFO) {
+    // Frame length with the FCS
+    uint32_t finfo = rxLength + 2;
+    memset(data, 0, length);
+    memcpy(data, &finfo, sizeof(finfo));
+    return;
+  }
+  TEST_ASSERT_EQUAL_UINT8(RX_BUFFER, header->bytes[0]);
+  TEST_ASSERT_TRUE(length <= rxLength);
+  memcpy(data, rxBuffer, length);
+  readLength = length;
+}
+
+void setUp() {
+  dwInit(&dev, &ops);
+  dev.deviceMode = RX_MODE;
+  dwAddressFilterInit(&filter);
+}
+
+void testThatFrameToShortAddressOfTheSetIsAccepted() {
+  // Fixture
+  dwAddressFilterAddShort(&filter, 0xBEEF, 0x0001);
+  dwAddressFilterAddShort(&filter, 0xDECA, 0x1234);
+
+  // Test
+  bool actual = dwAddressFilterMatch(&filter, shortFrame, sizeof(shortFrame));
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+}
+
+void testThatFrameToShortAddressOfAnotherPanIsDropped() {
+  // Fixture
+  dwAddressFilterAddShort(&filter, 0xBEEF, 0x1234);
+
+  // Test
+  bool actual = dwAddressFilterMatch(&filter, shortFrame, sizeof(shortFrame));
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatFrameToExtendedAddressOfTheSetIsAccepted() {
+  // Fixture
+  uint8_t frame[] = {0x41, 0xCC, 0x01, 0xCA, 0xDE, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+  dwAddressFilterAddExtended(&filter, 0x0102030405060708ull);
+
+  // Test
+  bool actual = dwAddressFilterMatch(&filter, frame, sizeof(frame));
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+}
+
+void testThatFrameToShortAddressInBroadcastPanIsAccepted() {
+  // Fixture
+  uint8_t frame[] = {0x41, 0x88, 0x17, 0xFF, 0xFF, 0x34, 0x12, 0x78, 0x56};
+  dwAddressFilterAddShort(&filter, 0xDECA, 0x1234);
+
+  // Test
+  bool actualKnown = dwAddressFilterMatch(&filter, frame, sizeof(frame));
+  frame[5] = 0x35;
+  bool actualUnknown = dwAddressFilterMatch(&filter, frame, sizeof(frame));
+
+  // Assert
+  TEST_ASSERT_TRUE(actualKnown);
+  TEST_ASSERT_FALSE(actualUnknown);
+}
+
+void testThatBroadcastIsAcceptedUnlessDisabled() {
+  // Fixture
+  uint8_t frame[] = {0x41, 0x88, 0x17, 0xCA, 0xDE, 0xFF, 0xFF, 0x78, 0x56};
+
+  // Test
+  bool actualEnabled = dwAddressFilterMatch(&filter, frame, sizeof(frame));
+  filter.acceptBroadcast = false;
+  bool actualDisabled = dwAddressFilterMatch(&filter, frame, sizeof(frame));
+
+  // Assert
+  TEST_ASSERT_TRUE(actualEnabled);
+  TEST_ASSERT_FALSE(actualDisabled);
+}
+
+void testThatFrameWithoutDestinationIsAccepted() {
+  // Fixture
+  uint8_t ack[] = {0x02, 0x00, 0x17};
+
+  // Test
+  bool actual = dwAddressFilterMatch(&filter, ack, sizeof(ack));
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+}
+
+void testThatBlinksAreAcceptedWhateverTheirSequenceNumber() {
+  // Fixture
+  uint8_t blink[DW_BLINK_FRAME_LENGTH] = {DW_BLINK_FRAME_CONTROL, 0x00, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+  dwAddressFilterAddShort(&filter, 0xDECA, 0x1234);
+  int accepted = 0;
+
+  // Test
+  for (int sequence = 0; sequence < 256; sequence++) {
+    blink[1] = (uint8_t)sequence;
+    accepted += dwAddressFilterMatch(&filter, blink, sizeof(blink));
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL(256, accepted);
+}
+
+void testThatAddFailsWhenSetIsFull() {
+  // Fixture
+  for (int i = 0; i < DW_ADDRESS_FILTER_CAPACITY; i++) {
+    TEST_ASSERT_TRUE(dwAddressFilterAddShort(&filter, 0xDECA, i));
+  }
+
+  // Test
+  bool actual = dwAddressFilterAddShort(&filter, 0xDECA, 0x1000);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_TRUE(dwAddressFilterAddShort(&filter, 0xDECA, 3));
+}
+
+void testThatAcceptReadsOnlyTheHeader() {
+  // Fixture
+  dwAddressFilterAddShort(&filter, 0xDECA, 0x1234);
+  rxBuffer = shortFrame;
+  rxLength = sizeof(shortFrame);
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_rxBuffer);
+
+  // Test
+  bool actual = dwAddressFilterAccept(&dev, &filter);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL(13, readLength);
+}
+
+void testThatAcceptReadsNoMoreThanTheFrame() {
+  // Fixture
+  // Data frame without payload nor source address
+  uint8_t frame[] = {0x41, 0x08, 0x17, 0xCA, 0xDE, 0x34, 0x12};
+  dwAddressFilterAddShort(&filter, 0xDECA, 0x1234);
+  rxBuffer = frame;
+  rxLength = sizeof(frame);
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_rxBuffer);
+
+  // Test
+  bool actual = dwAddressFilterAccept(&dev, &filter);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL(sizeof(frame), readLength);
+}
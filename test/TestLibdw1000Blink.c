@@ -0,0 +1,90 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000Blink.h"
+
+#include "mock_libdw1000Spi.h"
+
+static dwOps_t ops;
+static dwDevice_t dev;
+static dwBlink_t blink;
+
+// Writes seen by the fake SPI
+#define MAX_WRITES 4
+static uint8_t writeRegister[MAX_WRITES];
+static uint8_t writeData[MAX_WRITES][16];
+static size_t writeLength[MAX_WRITES];
+static int writeCount;
+
+static void dwSpiWriteHeader_record(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls) {
+  if (writeCount < MAX_WRITES) {
+    writeRegister[writeCount] = header->bytes[0] & 0x3f;
+    memcpy(writeData[writeCount], data, length);
+    writeLength[writeCount] = length;
+  }
+  writeCount++;
+}
+
+void setUp() {
+  dwInit(&dev, &ops);
+  writeCount = 0;
+}
+
+void testThatBlinkInitConfiguresSleepAfterTransmit() {
+  // Fixture
+  uint8_t wakeConfig[] = {0x40, 0x11};
+  dwSpiWrite_ExpectWithArray(&dev, 1, AON, AON_WCFG_SUB, wakeConfig, sizeof(wakeConfig), sizeof(wakeConfig));
+  uint8_t cfg0[] = {0x07};
+  dwSpiWrite_ExpectWithArray(&dev, 1, AON, AON_CFG0_SUB, cfg0, sizeof(cfg0), sizeof(cfg0));
+  uint8_t cfg1[] = {0x00};
+  dwSpiWrite_ExpectWithArray(&dev, 1, AON, AON_CFG1_SUB, cfg1, sizeof(cfg1), sizeof(cfg1));
+  dwSpiRead32_ExpectAndReturn(&dev, PMSC, PMSC_CTRL1_SUB, 0x00001238);
+  dwSpiWrite32_Expect(&dev, PMSC, PMSC_CTRL1_SUB, 0x00000a38);
+
+  // Test
+  dwBlinkInit(&dev, &blink, 0x0102030405060708ull);
+
+  // Assert
+  uint8_t expectedFrame[DW_BLINK_FRAME_LENGTH] = {0xc5, 0x00, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, blink.frame, DW_BLINK_FRAME_LENGTH);
+  TEST_ASSERT_EQUAL_UINT8(12, blink.txfctrl[0]);
+}
+
+void testThatBlinkIsSentWithThreeWrites() {
+  // Fixture
+  dwSpiWrite_Ignore();
+  dwSpiRead32_IgnoreAndReturn(0);
+  dwSpiWrite32_Ignore();
+  dwBlinkInit(&dev, &blink, 0x0102030405060708ull);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_record);
+
+  // Test
+  dwBlinkSend(&dev, &blink);
+
+  // Assert
+  TEST_ASSERT_EQUAL(3, writeCount);
+  TEST_ASSERT_EQUAL_UINT8(TX_BUFFER, writeRegister[0]);
+  TEST_ASSERT_EQUAL(DW_BLINK_FRAME_LENGTH, writeLength[0]);
+  TEST_ASSERT_EQUAL_UINT8(0xc5, writeData[0][0]);
+  TEST_ASSERT_EQUAL_UINT8(TX_FCTRL, writeRegister[1]);
+  TEST_ASSERT_EQUAL_UINT8(12, writeData[1][0]);
+  TEST_ASSERT_EQUAL_UINT8(SYS_CTRL, writeRegister[2]);
+  TEST_ASSERT_EQUAL(1, writeLength[2]);
+  TEST_ASSERT_EQUAL_UINT8(0x02, writeData[2][0]);
+}
+
+void testThatBlinkSequenceNumberIsIncremented() {
+  // Fixture
+  dwSpiWrite_Ignore();
+  dwSpiRead32_IgnoreAndReturn(0);
+  dwSpiWrite32_Ignore();
+  dwBlinkInit(&dev, &blink, 0);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_record);
+  dwBlinkSend(&dev, &blink);
+
+  // Test
+  dwBlinkSend(&dev, &blink);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(1, writeData[3][1]);
+}
@@ -0,0 +1,174 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000Bus.h"
+
+#include "mock_libdw1000Spi.h"
+
+// Fake bus operations recording the last access
+static uint8_t lastCs;
+static int transferCount;
+static int speedChangeCount;
+static dwSpiSpeed_t lastSpeed;
+
+static void busSpiRead(dwBus_t *bus, uint8_t cs, const void *header,
+                       size_t headerLength, void* data, size_t dataLength) {
+  lastCs = cs;
+  transferCount++;
+}
+
+static void busSpiWrite(dwBus_t *bus, uint8_t cs, const void *header,
+                        size_t headerLength, const void* data, size_t dataLength) {
+  lastCs = cs;
+  transferCount++;
+}
+
+static void busSpiSetSpeed(dwBus_t *bus, dwSpiSpeed_t speed) {
+  lastSpeed = speed;
+  speedChangeCount++;
+}
+
+static void busDelayms(dwBus_t *bus, unsigned int delay) {
+}
+
+static const dwBusOps_t busOps = {
+  .spiRead = busSpiRead,
+  .spiWrite = busSpiWrite,
+  .spiSetSpeed = busSpiSetSpeed,
+  .delayms = busDelayms,
+};
+
+static dwBus_t bus;
+static dwBusDevice_t device1;
+static dwBusDevice_t device2;
+
+// Records the devices whose interrupt has been serviced
+static dwDevice_t* servicedDevice;
+static int serviceCount;
+
+static void dwSpiReadHeader_status(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  servicedDevice = dev;
+  serviceCount++;
+  memset(data, 0, length);
+}
+
+void setUp() {
+  lastCs = 0xff;
+  transferCount = 0;
+  speedChangeCount = 0;
+  servicedDevice = NULL;
+  serviceCount = 0;
+
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_status);
+
+  dwBusInit(&bus, &busOps);
+  dwBusAttach(&bus, &device1, 3);
+  dwBusAttach(&bus, &device2, 7);
+}
+
+void testThatTransfersUseTheChipSelectOfTheDevice() {
+  // Fixture
+  uint8_t header[1] = {0};
+  uint8_t data[1];
+
+  // Test
+  device2.dev.ops->spiRead(&device2.dev, header, sizeof(header), data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(7, lastCs);
+
+  // Test
+  device1.dev.ops->spiWrite(&device1.dev, header, sizeof(header), data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(3, lastCs);
+  TEST_ASSERT_EQUAL(2, transferCount);
+}
+
+void testThatBusSpeedFollowsTheDeviceOfTheTransfer() {
+  // Fixture
+  uint8_t header[1] = {0};
+  uint8_t data[1];
+  device1.dev.ops->spiSetSpeed(&device1.dev, dwSpiSpeedHigh);
+
+  // Test
+  device1.dev.ops->spiRead(&device1.dev, header, sizeof(header), data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL(dwSpiSpeedHigh, lastSpeed);
+
+  // Test
+  device2.dev.ops->spiRead(&device2.dev, header, sizeof(header), data, sizeof(data));
+  device2.dev.ops->spiRead(&device2.dev, header, sizeof(header), data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL(dwSpiSpeedLow, lastSpeed);
+  TEST_ASSERT_EQUAL(2, speedChangeCount);
+}
+
+void testThatInterruptIsServicedRightAwayWhenBusIsFree() {
+  // Fixture
+
+  // Test
+  dwBusHandleInterrupt(&device2);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, serviceCount);
+  TEST_ASSERT_EQUAL_PTR(&device2.dev, servicedDevice);
+  TEST_ASSERT_EQUAL_UINT8(0, device2.pending);
+}
+
+void testThatInterruptIsDeferredUntilBusIsUnlocked() {
+  // Fixture
+  device1.dev.ops->lock(&device1.dev);
+
+  // Test
+  dwBusHandleInterrupt(&device2);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, serviceCount);
+  TEST_ASSERT_EQUAL_UINT8(1, device2.pending);
+
+  // Test
+  device1.dev.ops->unlock(&device1.dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, serviceCount);
+  TEST_ASSERT_EQUAL_PTR(&device2.dev, servicedDevice);
+  TEST_ASSERT_EQUAL_UINT8(0, device2.pending);
+}
+
+void testThatInterruptIsDeferredUntilOutermostUnlock() {
+  // Fixture
+  device1.dev.ops->lock(&device1.dev);
+  device1.dev.ops->lock(&device1.dev);
+  dwBusHandleInterrupt(&device2);
+
+  // Test
+  device1.dev.ops->unlock(&device1.dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, serviceCount);
+
+  // Test
+  device1.dev.ops->unlock(&device1.dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, serviceCount);
+}
+
+void testThatAttachFailsWhenBusIsFull() {
+  // Fixture
+  static dwBusDevice_t devices[DW_BUS_MAX_DEVICES];
+  dwBusInit(&bus, &busOps);
+  for (int i = 0; i < DW_BUS_MAX_DEVICES; i++) {
+    TEST_ASSERT_EQUAL(DW_ERROR_OK, dwBusAttach(&bus, &devices[i], i));
+  }
+  dwBusDevice_t extra;
+
+  // Test
+  int actual = dwBusAttach(&bus, &extra, DW_BUS_MAX_DEVICES);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_BUS_FULL, actual);
+}
@@ -0,0 +1,127 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000Cir.h"
+
+#include "mock_libdw1000Spi.h"
+
+static dwOps_t ops;
+static dwDevice_t dev;
+static dwCirReader_t reader;
+static dwCirSample_t samples[64];
+
+// Fake registers
+static uint8_t pmscctrl0[2];
+static int accReads;
+static uint32_t lastAccAddress;
+static size_t lastAccLength;
+
+static void dwSpiRead_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, void* data, size_t length, int cmock_num_calls) {
+  uint8_t* bytes = data;
+  if (regid == PMSC) {
+    memcpy(data, pmscctrl0, length);
+  } else if (regid == ACC_MEM) {
+    // Dummy byte, then sample i is {i, -i}
+    bytes[0] = 0xAA;
+    for (size_t i = 1; i < length; i += 4) {
+      int16_t index = (int16_t)((address + i - 1) / 4);
+      int16_t sample[2] = {index, (int16_t)-index};
+      memcpy(&bytes[i], sample, sizeof(sample));
+    }
+    accReads++;
+    lastAccAddress = address;
+    lastAccLength = length;
+  }
+}
+
+static void dwSpiWrite_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+  if (regid == PMSC) {
+    memcpy(pmscctrl0, data, length);
+  }
+}
+
+void setUp() {
+  dwInit(&dev, &ops);
+  pmscctrl0[0] = 0x01;
+  pmscctrl0[1] = 0x02;
+  accReads = 0;
+  dwSpiRead_StubWithCallback(dwSpiRead_fake);
+  dwSpiWrite_StubWithCallback(dwSpiWrite_fake);
+}
+
+void testThatStartForcesAccumulatorClocks() {
+  // Fixture
+  dwSpiRead16_ExpectAndReturn(&dev, RX_TIME, FP_INDEX_SUB, 750 << 6);
+
+  // Test
+  dwCirStart(&dev, &reader, samples, 8, 40);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX8(0x49, pmscctrl0[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x82, pmscctrl0[1]);
+  TEST_ASSERT_EQUAL_UINT16(742, reader.first);
+  TEST_ASSERT_EQUAL_UINT16(40, reader.count);
+}
+
+void testThatWindowIsReadInChunksAroundFirstPath() {
+  // Fixture
+  dwSpiRead16_ExpectAndReturn(&dev, RX_TIME, FP_INDEX_SUB, (750 << 6) | 0x20);
+  dwCirStart(&dev, &reader, samples, 8, 40);
+
+  // Test
+  bool actualFirst = dwCirRead(&dev, &reader);
+  bool actualLast = dwCirRead(&dev, &reader);
+
+  // Assert
+  TEST_ASSERT_FALSE(actualFirst);
+  TEST_ASSERT_TRUE(actualLast);
+  TEST_ASSERT_EQUAL(2, accReads);
+  TEST_ASSERT_EQUAL_UINT32((742 + DW_CIR_CHUNK) * 4, lastAccAddress);
+  TEST_ASSERT_EQUAL(1 + (40 - DW_CIR_CHUNK) * 4, lastAccLength);
+  for (int i = 0; i < 40; i++) {
+    TEST_ASSERT_EQUAL_INT16(742 + i, samples[i].real);
+    TEST_ASSERT_EQUAL_INT16(-742 - i, samples[i].imaginary);
+  }
+}
+
+void testThatClocksAreReleasedAfterLastChunk() {
+  // Fixture
+  dwSpiRead16_ExpectAndReturn(&dev, RX_TIME, FP_INDEX_SUB, 750 << 6);
+  dwCirStart(&dev, &reader, samples, 8, 16);
+
+  // Test
+  bool actual = dwCirRead(&dev, &reader);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL_HEX8(0x01, pmscctrl0[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x02, pmscctrl0[1]);
+}
+
+void testThatWindowIsClippedToAccumulator() {
+  // Fixture
+  dev.pulseFrequency = TX_PULSE_FREQ_16MHZ;
+  dwSpiRead16_ExpectAndReturn(&dev, RX_TIME, FP_INDEX_SUB, 985 << 6);
+
+  // Test
+  dwCirStart(&dev, &reader, samples, 4, 64);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT16(981, reader.first);
+  TEST_ASSERT_EQUAL_UINT16(DW_CIR_LENGTH_16MHZ - 981, reader.count);
+}
+
+void testThatStopReleasesClocks() {
+  // Fixture
+  dwSpiRead16_ExpectAndReturn(&dev, RX_TIME, FP_INDEX_SUB, 750 << 6);
+  dwCirStart(&dev, &reader, samples, 8, 40);
+
+  // Test
+  dwCirStop(&dev, &reader);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX8(0x01, pmscctrl0[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x02, pmscctrl0[1]);
+  TEST_ASSERT_TRUE(dwCirRead(&dev, &reader));
+  TEST_ASSERT_EQUAL(0, accReads);
+}
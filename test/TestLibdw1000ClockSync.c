@@ -0,0 +1,212 @@
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000ClockSync.h"
+
+#include "mock_libdw1000Spi.h"
+
+static dwClockSync_t sync;
+
+// Simulated master clock running 'ppm' faster than the local clock
+static const uint64_t period = 6389760000ull; // 100ms
+static uint64_t masterStart;
+static double ppm;
+
+static dwTime_t localTime(unsigned int beacon, uint64_t localStart) {
+  dwTime_t time = {.full = (localStart + beacon * period) & TIME_MASK};
+  return time;
+}
+
+static dwTime_t masterTime(unsigned int beacon) {
+  uint64_t elapsed = (uint64_t)(beacon * period * (1.0 + ppm * 1e-6));
+  dwTime_t time = {.full = (masterStart + elapsed) & TIME_MASK};
+  return time;
+}
+
+static void feed(unsigned int beacons, uint64_t localStart) {
+  for (unsigned int i = 0; i < beacons; i++) {
+    dwTime_t master = masterTime(i);
+    dwTime_t local = localTime(i, localStart);
+    dwClockSyncUpdate(&sync, &master, &local);
+  }
+}
+
+static int64_t error(dwTime_t actual, dwTime_t expected) {
+  int64_t diff = (int64_t)((actual.full - expected.full) & TIME_MASK);
+  if (diff > (int64_t)(TIME_MASK / 2)) {
+    diff -= (int64_t)(TIME_MASK + 1);
+  }
+  return diff;
+}
+
+void setUp() {
+  dwClockSyncInit(&sync, 1);
+  masterStart = 0x1234567890ull;
+  ppm = 12.5;
+}
+
+void testThatBeaconIsEncodedAndDecoded() {
+  // Fixture
+  uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH];
+  dwTime_t txTime = {.full = 0xab12345678ull};
+  uint8_t masterId;
+  uint8_t sequence;
+  dwTime_t decoded;
+
+  // Test
+  unsigned int length = dwClockSyncEncodeBeacon(data, 3, 42, &txTime);
+  bool actual = dwClockSyncDecodeBeacon(data, length, &masterId, &sequence, &decoded);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL_UINT8(3, masterId);
+  TEST_ASSERT_EQUAL_UINT8(42, sequence);
+  TEST_ASSERT_EQUAL_UINT64(txTime.full, decoded.full);
+}
+
+void testThatOtherFramesAreNotDecodedAsBeacons() {
+  // Fixture
+  uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH] = {0};
+  uint8_t masterId;
+  uint8_t sequence;
+  dwTime_t decoded;
+
+  // Test
+  bool actual = dwClockSyncDecodeBeacon(data, sizeof(data), &masterId, &sequence, &decoded);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatNotSynchronizedWithOneBeacon() {
+  // Fixture
+  feed(1, 0);
+
+  // Test
+  bool actual = dwClockSyncIsSynchronized(&sync);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+}
+
+void testThatDriftIsEstimated() {
+  // Fixture
+  feed(DW_CLOCKSYNC_WINDOW + 2, 0);
+
+  // Test
+  double actual = dwClockSyncDriftPpm(&sync);
+
+  // Assert
+  TEST_ASSERT_TRUE(dwClockSyncIsSynchronized(&sync));
+  TEST_ASSERT_TRUE(fabs(actual - ppm) < 0.001);
+}
+
+void testThatLocalTimeIsMappedToNetworkTimeWithinOneUnit() {
+  // Fixture
+  feed(DW_CLOCKSYNC_WINDOW, 0);
+  // Half a period after the last beacon
+  unsigned int last = DW_CLOCKSYNC_WINDOW - 1;
+  dwTime_t local = {.full = localTime(last, 0).full + period / 2};
+  uint64_t elapsed = (uint64_t)((last * period + period / 2) * (1.0 + ppm * 1e-6));
+  dwTime_t expected = {.full = (masterStart + elapsed) & TIME_MASK};
+
+  // Test
+  dwTime_t actual = dwClockSyncToNetwork(&sync, &local);
+
+  // Assert
+  TEST_ASSERT_TRUE(llabs(error(actual, expected)) <= 1);
+}
+
+void testThatNetworkTimeIsMappedBackToLocalTime() {
+  // Fixture
+  feed(DW_CLOCKSYNC_WINDOW, 0);
+  dwTime_t local = {.full = localTime(DW_CLOCKSYNC_WINDOW, 0).full};
+  dwTime_t network = dwClockSyncToNetwork(&sync, &local);
+
+  // Test
+  dwTime_t actual = dwClockSyncToLocal(&sync, &network);
+
+  // Assert
+  TEST_ASSERT_TRUE(llabs(error(actual, local)) <= 1);
+}
+
+void testThatTrackingHandlesCounterWrap() {
+  // Fixture
+  // The local counter wraps after the third beacon
+  uint64_t localStart = TIME_MASK + 1 - 3 * period + 1000;
+  masterStart = TIME_MASK - 5 * period;
+  feed(DW_CLOCKSYNC_WINDOW + 4, localStart);
+
+  // Test
+  double actual = dwClockSyncDriftPpm(&sync);
+
+  // Assert
+  TEST_ASSERT_TRUE(fabs(actual - ppm) < 0.001);
+}
+
+void testThatSingleOutlierIsDropped() {
+  // Fixture
+  feed(DW_CLOCKSYNC_WINDOW, 0);
+  // 3us off
+  dwTime_t master = masterTime(DW_CLOCKSYNC_WINDOW);
+  master.full += 3 * DW_CLOCKSYNC_MAX_ERROR;
+  dwTime_t local = localTime(DW_CLOCKSYNC_WINDOW, 0);
+  bool actualOutlier = dwClockSyncUpdate(&sync, &master, &local);
+  master = masterTime(DW_CLOCKSYNC_WINDOW + 1);
+  local = localTime(DW_CLOCKSYNC_WINDOW + 1, 0);
+
+  // Test
+  bool actual = dwClockSyncUpdate(&sync, &master, &local);
+
+  // Assert
+  TEST_ASSERT_FALSE(actualOutlier);
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_TRUE(dwClockSyncIsSynchronized(&sync));
+  TEST_ASSERT_TRUE(fabs(dwClockSyncDriftPpm(&sync) - ppm) < 0.001);
+  TEST_ASSERT_TRUE(llabs(error(dwClockSyncToNetwork(&sync, &local), master)) <= 1);
+}
+
+void testThatConsecutiveMismatchesRestartTracking() {
+  // Fixture
+  feed(DW_CLOCKSYNC_WINDOW, 0);
+  // The master clock jumped
+  masterStart += 10 * DW_CLOCKSYNC_MAX_ERROR;
+  bool actual[DW_CLOCKSYNC_MAX_MISMATCHES];
+
+  // Test
+  for (int i = 0; i < DW_CLOCKSYNC_MAX_MISMATCHES; i++) {
+    dwTime_t master = masterTime(DW_CLOCKSYNC_WINDOW + i);
+    dwTime_t local = localTime(DW_CLOCKSYNC_WINDOW + i, 0);
+    actual[i] = dwClockSyncUpdate(&sync, &master, &local);
+    if (i < DW_CLOCKSYNC_MAX_MISMATCHES - 1) {
+      TEST_ASSERT_TRUE(dwClockSyncIsSynchronized(&sync));
+    }
+  }
+
+  // Assert
+  for (int i = 0; i < DW_CLOCKSYNC_MAX_MISMATCHES; i++) {
+    TEST_ASSERT_FALSE(actual[i]);
+  }
+  TEST_ASSERT_FALSE(dwClockSyncIsSynchronized(&sync));
+  dwTime_t master = masterTime(DW_CLOCKSYNC_WINDOW + DW_CLOCKSYNC_MAX_MISMATCHES);
+  dwTime_t local = localTime(DW_CLOCKSYNC_WINDOW + DW_CLOCKSYNC_MAX_MISMATCHES, 0);
+  TEST_ASSERT_TRUE(dwClockSyncUpdate(&sync, &master, &local));
+  TEST_ASSERT_TRUE(dwClockSyncIsSynchronized(&sync));
+}
+
+void testThatBeaconsOfOtherMastersAreIgnored() {
+  // Fixture
+  uint8_t data[DW_CLOCKSYNC_BEACON_LENGTH];
+  dwTime_t txTime = {.full = 1000};
+  dwTime_t rxTime = {.full = 2000};
+  dwClockSyncEncodeBeacon(data, 2, 0, &txTime);
+
+  // Test
+  bool actual = dwClockSyncHandleBeacon(&sync, data, sizeof(data), &rxTime);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_EQUAL_UINT8(0, sync.count);
+}
@@ -0,0 +1,125 @@
+#define DW_COMPACT_DEVICE
+
+#include <string.h>
+
+#include "unity.h"
+
+#include "mock_libdw1000Spi.h"
+
+// Include c file to test the compact build
+#include "libdw1000.c"
+
+static dwOps_t ops;
+static dwDevice_t dev1;
+static dwDevice_t dev2;
+
+static int sentHandlerCalls;
+static void sentHandler(dwDevice_t *dev) {
+  (void)dev;
+  sentHandlerCalls++;
+}
+
+static void receivedHandler(dwDevice_t *dev) {
+  (void)dev;
+}
+
+static void dwSpiReadHeader_transmitDone(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  (void)dev;
+  (void)header;
+  (void)cmock_num_calls;
+  uint64_t status = 1ull << TXFRS_BIT;
+  memset(data, 0, length);
+  memcpy(data, &status, length < sizeof(status) ? length : sizeof(status));
+}
+
+static void dwSpiWriteHeader_ignore(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls) {
+  (void)dev;
+  (void)header;
+  (void)data;
+  (void)length;
+  (void)cmock_num_calls;
+}
+
+void setUp() {
+  dwInit(&dev1, &ops);
+  dwInit(&dev2, &ops);
+  sentHandlerCalls = 0;
+}
+
+void testThatFlagsAndModesArePackedWithoutLoss() {
+  // Fixture
+
+  // Test
+  dev1.preambleCode = PREAMBLE_CODE_64MHZ_12;
+  dev1.preambleLength = TX_PREAMBLE_LEN_4096;
+  dev1.channel = CHANNEL_7;
+  dev1.dataRate = TRX_RATE_6800KBPS;
+  dev1.pulseFrequency = TX_PULSE_FREQ_64MHZ;
+  dev1.extendedFrameLength = FRAME_LENGTH_EXTENDED;
+  dev1.permanentReceive = true;
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(PREAMBLE_CODE_64MHZ_12, dev1.preambleCode);
+  TEST_ASSERT_EQUAL_UINT8(TX_PREAMBLE_LEN_4096, dev1.preambleLength);
+  TEST_ASSERT_EQUAL_UINT8(CHANNEL_7, dev1.channel);
+  TEST_ASSERT_EQUAL_UINT8(TRX_RATE_6800KBPS, dev1.dataRate);
+  TEST_ASSERT_EQUAL_UINT8(TX_PULSE_FREQ_64MHZ, dev1.pulseFrequency);
+  TEST_ASSERT_EQUAL_UINT8(FRAME_LENGTH_EXTENDED, dev1.extendedFrameLength);
+  TEST_ASSERT_TRUE(dev1.permanentReceive);
+  TEST_ASSERT_FALSE(dev1.autoAck);
+}
+
+void testThatAttachDoesNotModifyTheDefaultHandlers() {
+  // Fixture
+
+  // Test
+  dwAttachSentHandler(&dev1, sentHandler);
+
+  // Assert
+  TEST_ASSERT_TRUE(dev1.handlers == dev2.handlers);
+  TEST_ASSERT_TRUE(dev2.handlers->handleSent != sentHandler);
+}
+
+void testThatAttachModifiesTheTableSetWithSetHandlers() {
+  // Fixture
+  dwHandlers_t handlers = {0};
+  dwSetHandlers(&dev1, &handlers);
+
+  // Test
+  dwAttachSentHandler(&dev1, sentHandler);
+  dwAttachReceivedHandler(&dev1, receivedHandler);
+
+  // Assert
+  TEST_ASSERT_TRUE(handlers.handleSent == sentHandler);
+  TEST_ASSERT_TRUE(handlers.handleReceived == receivedHandler);
+  TEST_ASSERT_TRUE(dev2.handlers->handleSent != sentHandler);
+  TEST_ASSERT_TRUE(dev2.handlers->handleReceived != receivedHandler);
+}
+
+void testThatDevicesSharingATableShareTheHandlers() {
+  // Fixture
+  dwHandlers_t handlers = {0};
+  dwSetHandlers(&dev1, &handlers);
+  dwSetHandlers(&dev2, &handlers);
+
+  // Test
+  dwAttachSentHandler(&dev1, sentHandler);
+
+  // Assert
+  TEST_ASSERT_TRUE(dev2.handlers->handleSent == sentHandler);
+}
+
+void testThatInterruptIsDispatchedThroughTheHandlerTable() {
+  // Fixture
+  dwHandlers_t handlers = {0};
+  dwSetHandlers(&dev1, &handlers);
+  dwAttachSentHandler(&dev1, sentHandler);
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_transmitDone);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_ignore);
+
+  // Test
+  dwHandleInterrupt(&dev1);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, sentHandlerCalls);
+}
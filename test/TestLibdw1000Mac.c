@@ -0,0 +1,163 @@
+#include "unity.h"
+#include "libdw1000Mac.h"
+
+#include <string.h>
+
+static uint8_t buffer[64];
+static dwMacHeader_t header;
+
+void setUp() {
+  memset(buffer, 0, sizeof(buffer));
+  memset(&header, 0, sizeof(header));
+}
+
+void testThatDataFrameWithShortAddressesAndPanCompressionIsEncoded() {
+  // Fixture
+  header.type = DW_MAC_TYPE_DATA;
+  header.panCompression = true;
+  header.destinationMode = DW_MAC_ADDRESS_SHORT;
+  header.sourceMode = DW_MAC_ADDRESS_SHORT;
+  header.sequence = 0x17;
+  header.destinationPan = 0xDECA;
+  header.destination = 0x1234;
+  header.source = 0x5678;
+
+  uint8_t expected[] = {0x41, 0x88, 0x17, 0xCA, 0xDE, 0x34, 0x12, 0x78, 0x56};
+
+  // Test
+  size_t actual = dwMacEncode(buffer, &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(sizeof(expected), actual);
+  TEST_ASSERT_EQUAL(sizeof(expected), dwMacHeaderLength(&header));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+void testThatFrameWithExtendedAddressesAndBothPansIsEncoded() {
+  // Fixture
+  header.type = DW_MAC_TYPE_DATA;
+  header.ackRequest = true;
+  header.version = 1;
+  header.destinationMode = DW_MAC_ADDRESS_EXTENDED;
+  header.sourceMode = DW_MAC_ADDRESS_EXTENDED;
+  header.sequence = 1;
+  header.destinationPan = 0x1111;
+  header.sourcePan = 0x2222;
+  header.destination = 0x0102030405060708ull;
+  header.source = 0x1112131415161718ull;
+
+  uint8_t expected[] = {0x21, 0xDC, 0x01,
+                        0x11, 0x11, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+                        0x22, 0x22, 0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12, 0x11};
+
+  // Test
+  size_t actual = dwMacEncode(buffer, &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_MAC_MAX_HEADER_LENGTH, actual);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+void testThatPanCompressionIsIgnoredWithOnlyOneAddress() {
+  // Fixture
+  header.type = DW_MAC_TYPE_DATA;
+  header.panCompression = true;
+  header.sourceMode = DW_MAC_ADDRESS_SHORT;
+  header.sourcePan = 0xDECA;
+  header.source = 0x5678;
+
+  uint8_t expected[] = {0x01, 0x80, 0x00, 0xCA, 0xDE, 0x78, 0x56};
+
+  // Test
+  size_t actual = dwMacEncode(buffer, &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(sizeof(expected), actual);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+void testThatDataFrameIsDecodedInPlace() {
+  // Fixture
+  uint8_t frame[] = {0x41, 0xC8, 0x2A, 0xCA, 0xDE, 0x34, 0x12,
+                     0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+                     0xAA, 0xBB};
+
+  // Test
+  size_t actual = dwMacDecode(frame, sizeof(frame), &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(15, actual);
+  TEST_ASSERT_EQUAL_UINT8(0xAA, frame[actual]);
+  TEST_ASSERT_EQUAL_UINT8(DW_MAC_TYPE_DATA, header.type);
+  TEST_ASSERT_TRUE(header.panCompression);
+  TEST_ASSERT_FALSE(header.ackRequest);
+  TEST_ASSERT_EQUAL_UINT8(0x2A, header.sequence);
+  TEST_ASSERT_EQUAL_UINT8(DW_MAC_ADDRESS_SHORT, header.destinationMode);
+  TEST_ASSERT_EQUAL_UINT8(DW_MAC_ADDRESS_EXTENDED, header.sourceMode);
+  TEST_ASSERT_EQUAL_UINT16(0xDECA, header.destinationPan);
+  TEST_ASSERT_EQUAL_UINT16(0xDECA, header.sourcePan);
+  TEST_ASSERT_EQUAL_UINT64(0x1234, header.destination);
+  TEST_ASSERT_EQUAL_UINT64(0x0102030405060708ull, header.source);
+}
+
+void testThatEncodedHeaderIsDecodedBack() {
+  // Fixture
+  dwMacHeader_t expected = {
+    .type = DW_MAC_TYPE_MAC_COMMAND, .framePending = true, .version = 1,
+    .destinationMode = DW_MAC_ADDRESS_EXTENDED, .sourceMode = DW_MAC_ADDRESS_SHORT,
+    .sequence = 200, .destinationPan = 0x0102, .sourcePan = 0x0304,
+    .destination = 0xA1A2A3A4A5A6A7A8ull, .source = 0xBEEF,
+  };
+  size_t length = dwMacEncode(buffer, &expected);
+
+  // Test
+  size_t actual = dwMacDecode(buffer, length, &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(length, actual);
+  TEST_ASSERT_EQUAL_UINT8(expected.type, header.type);
+  TEST_ASSERT_TRUE(header.framePending);
+  TEST_ASSERT_EQUAL_UINT8(expected.version, header.version);
+  TEST_ASSERT_EQUAL_UINT8(expected.destinationMode, header.destinationMode);
+  TEST_ASSERT_EQUAL_UINT8(expected.sourceMode, header.sourceMode);
+  TEST_ASSERT_EQUAL_UINT8(expected.sequence, header.sequence);
+  TEST_ASSERT_EQUAL_UINT16(expected.destinationPan, header.destinationPan);
+  TEST_ASSERT_EQUAL_UINT16(expected.sourcePan, header.sourcePan);
+  TEST_ASSERT_EQUAL_UINT64(expected.destination, header.destination);
+  TEST_ASSERT_EQUAL_UINT64(expected.source, header.source);
+}
+
+void testThatTruncatedFrameIsRejected() {
+  // Fixture
+  uint8_t frame[] = {0x41, 0x88, 0x17, 0xCA, 0xDE, 0x34, 0x12, 0x78};
+
+  // Test
+  size_t actual = dwMacDecode(frame, sizeof(frame), &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, actual);
+}
+
+void testThatSecuredFrameIsRejected() {
+  // Fixture
+  uint8_t frame[] = {0x49, 0x88, 0x17, 0xCA, 0xDE, 0x34, 0x12, 0x78, 0x56, 0x00};
+
+  // Test
+  size_t actual = dwMacDecode(frame, sizeof(frame), &header);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, actual);
+}
+
+void testThatFrameTypeAndSequenceAreReadWithoutDecoding() {
+  // Fixture
+  uint8_t frame[] = {0x02, 0x00, 0x33};
+
+  // Test
+  uint8_t actualType = dwMacFrameType(frame);
+  uint8_t actualSequence = dwMacSequence(frame);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(DW_MAC_TYPE_ACK, actualType);
+  TEST_ASSERT_EQUAL_UINT8(0x33, actualSequence);
+}
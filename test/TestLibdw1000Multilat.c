@@ -0,0 +1,135 @@
+#include <math.h>
+#include "unity.h"
+#include "libdw1000Multilat.h"
+
+#define TAGS 100
+
+static dwMultilatAnchors_t anchors = {
+  .x = {0.0f, 10.0f, 10.0f, 0.0f, 5.0f},
+  .y = {0.0f, 0.0f, 8.0f, 8.0f, 4.0f},
+  .z = {0.0f, 0.5f, 3.0f, 2.5f, 3.0f},
+  .count = 5,
+};
+
+static float tof[5 * TAGS];
+static float x[TAGS], y[TAGS], z[TAGS], residual[TAGS];
+static float trueX[TAGS], trueY[TAGS], trueZ[TAGS];
+static dwMultilatBatch_t batch;
+
+static void setTagWith(const dwMultilatAnchors_t *with, int t, float tx, float ty, float tz) {
+  trueX[t] = tx;
+  trueY[t] = ty;
+  trueZ[t] = tz;
+  for (int a = 0; a < with->count; a++) {
+    float dx = tx - with->x[a];
+    float dy = ty - with->y[a];
+    float dz = tz - with->z[a];
+    tof[a * TAGS + t] = sqrtf(dx * dx + dy * dy + dz * dz) * DISTANCE_OF_RADIO_INV;
+  }
+  x[t] = y[t] = z[t] = NAN;
+}
+
+static void setTag(int t, float tx, float ty, float tz) {
+  setTagWith(&anchors, t, tx, ty, tz);
+}
+
+void setUp() {
+  batch = (dwMultilatBatch_t){.tof = tof, .stride = TAGS, .x = x, .y = y, .z = z, .residual = residual, .tagCount = 1};
+}
+
+void testThatTagPositionIsSolvedFromTimesOfFlight() {
+  // Fixture
+  setTag(0, 3.0f, 2.0f, 1.0f);
+
+  // Test
+  dwMultilatSolve(&anchors, &batch);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.0f, x[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, y[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, z[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, residual[0]);
+}
+
+void testThatAllTagsOfSeveralBlocksAreSolved() {
+  // Fixture
+  for (int t = 0; t < TAGS; t++) {
+    setTag(t, 1.0f + (t % 10) * 0.8f, 1.0f + (t / 10) * 0.6f, 0.5f + (t % 3) * 0.5f);
+  }
+  batch.tagCount = TAGS;
+
+  // Test
+  dwMultilatSolve(&anchors, &batch);
+
+  // Assert
+  for (int t = 0; t < TAGS; t++) {
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, trueX[t], x[t]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, trueY[t], y[t]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, trueZ[t], z[t]);
+  }
+}
+
+void testThatSolutionStartsFromPreviousPosition() {
+  // Fixture
+  setTag(0, 3.0f, 2.0f, 1.0f);
+  dwMultilatSolve(&anchors, &batch);
+  setTag(0, 3.1f, 2.0f, 1.0f);
+  x[0] = 3.0f;
+  y[0] = 2.0f;
+  z[0] = 1.0f;
+
+  // Test
+  dwMultilatSolve(&anchors, &batch);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.1f, x[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, y[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, z[0]);
+}
+
+void testThatMissingRangeIsIgnored() {
+  // Fixture
+  setTag(0, 6.0f, 5.0f, 1.5f);
+  tof[2 * TAGS] = 0.0f;
+
+  // Test
+  dwMultilatSolve(&anchors, &batch);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.0f, x[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, y[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.5f, z[0]);
+}
+
+void testThatTagWithLessThanFourRangesIsNotSolved() {
+  // Fixture
+  setTag(0, 6.0f, 5.0f, 1.5f);
+  tof[0] = 0.0f;
+  tof[TAGS] = 0.0f;
+
+  // Test
+  dwMultilatSolve(&anchors, &batch);
+
+  // Assert
+  TEST_ASSERT_TRUE(isnan(x[0]));
+  TEST_ASSERT_TRUE(isnan(residual[0]));
+}
+
+void testThatTagBelowCoplanarAnchorsIsSolved() {
+  // Fixture
+  dwMultilatAnchors_t ceiling = {
+    .x = {0.0f, 10.0f, 10.0f, 0.0f},
+    .y = {0.0f, 0.0f, 8.0f, 8.0f},
+    .z = {3.0f, 3.0f, 3.0f, 3.0f},
+    .count = 4,
+  };
+  setTagWith(&ceiling, 0, 3.0f, 2.0f, 1.0f);
+
+  // Test
+  dwMultilatSolve(&ceiling, &batch);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.0f, x[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, y[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, z[0]);
+}
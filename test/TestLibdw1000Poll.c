@@ -0,0 +1,94 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000Poll.h"
+
+#include "mock_libdw1000Spi.h"
+#include "mock_dwTestOps.h"
+
+static dwOps_t ops = {
+  .spiRead = spiRead,
+  .spiWrite = spiWrite,
+  .spiSetSpeed = spiSetSpeed,
+  .delayms = delayms,
+  .reset = reset,
+  .delayus = delayus
+};
+
+static dwDevice_t dev;
+
+// Number of status reads before the event is reported
+static int readsBeforeEvent;
+static int statusReads;
+
+static void dwSpiReadHeader_status(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  uint64_t status = 0;
+  statusReads++;
+  if (statusReads > readsBeforeEvent) {
+    status = 1ull << TXFRS_BIT;
+  }
+  memcpy(data, &status, length);
+}
+
+void setUp() {
+  dwInit(&dev, &ops);
+  dev.dataRate = TRX_RATE_6800KBPS;
+  dev.pulseFrequency = TX_PULSE_FREQ_64MHZ;
+  dev.preambleLength = TX_PREAMBLE_LEN_128;
+  dev.sysmask = 1ul << TXFRS_BIT;
+
+  statusReads = 0;
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_status);
+  dwSpiWriteHeader_Ignore();
+}
+
+void testThatTransmitIsPolledAfterFrameDurationWithBackoff() {
+  // Fixture
+  // 10 bytes payload and 2 bytes CRC: 179us at 6.8Mbps with 128 symbols preamble
+  dev.txfctrl[0] = 12;
+  dev.txfctrl[1] = 0;
+  readsBeforeEvent = 2;
+
+  delayus_Expect(&dev, 179);
+  delayus_Expect(&dev, DW_POLL_MIN_INTERVAL_US);
+  delayus_Expect(&dev, DW_POLL_MIN_INTERVAL_US * 2);
+
+  // Test
+  bool actual = dwPollTransmit(&dev, 10000);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL(3, statusReads);
+}
+
+void testThatReceiveWaitsForFrameOfExpectedLengthWithCrc() {
+  // Fixture
+  readsBeforeEvent = 0;
+
+  delayus_Expect(&dev, 179);
+
+  // Test
+  bool actual = dwPollReceive(&dev, 10, 10000);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_EQUAL(1, statusReads);
+}
+
+void testThatPollingStopsAtTimeout() {
+  // Fixture
+  dev.txfctrl[0] = 12;
+  dev.txfctrl[1] = 0;
+  readsBeforeEvent = 100;
+
+  delayus_Expect(&dev, 179);
+  delayus_Expect(&dev, 16);
+  delayus_Expect(&dev, 5);
+
+  // Test
+  bool actual = dwPollTransmit(&dev, 200);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_EQUAL(3, statusReads);
+}
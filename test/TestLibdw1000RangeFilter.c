@@ -0,0 +1,110 @@
+#include "unity.h"
+#include "libdw1000RangeFilter.h"
+
+static dwRangeFilter_t filter;
+
+static void addRanges(const float ranges[], int count) {
+  for (int i = 0; i < count; i++) {
+    dwRangeFilterUpdate(&filter, ranges[i], i * 0.1f, 0.0f);
+  }
+}
+
+void setUp() {
+  dwRangeFilterInit(&filter);
+}
+
+void testThatFilteredRangeIsMedianOfWindow() {
+  // Fixture
+  float ranges[] = {2.0f, 2.3f, 1.9f, 2.1f};
+  addRanges(ranges, 4);
+
+  // Test
+  bool actual = dwRangeFilterUpdate(&filter, 2.2f, 0.4f, 0.0f);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.1f, filter.range);
+}
+
+void testThatNonLineOfSightRangeIsRejected() {
+  // Fixture
+
+  // Test
+  bool actual = dwRangeFilterUpdate(&filter, 2.0f, 0.0f, 12.0f);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FALSE(filter.valid);
+  TEST_ASSERT_EQUAL_UINT8(0, filter.count);
+}
+
+void testThatOutlierIsRejected() {
+  // Fixture
+  float ranges[] = {2.0f, 2.02f, 1.98f, 2.01f, 1.99f, 2.0f};
+  addRanges(ranges, 6);
+
+  // Test
+  bool actual = dwRangeFilterUpdate(&filter, 3.5f, 0.6f, 0.0f);
+
+  // Assert
+  TEST_ASSERT_FALSE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, filter.range);
+}
+
+void testThatMedianFollowsRealJump() {
+  // Fixture
+  float ranges[] = {2.0f, 2.02f, 1.98f, 2.01f, 1.99f, 5.0f, 5.01f};
+  addRanges(ranges, 7);
+
+  // Test
+  bool actual = dwRangeFilterUpdate(&filter, 4.99f, 0.7f, 0.0f);
+
+  // Assert
+  TEST_ASSERT_TRUE(actual);
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4.99f, filter.range);
+}
+
+void testThatSortedWindowHoldsTheLastRanges() {
+  // Fixture
+  float ranges[] = {5.0f, 1.0f, 4.0f, 2.0f, 3.0f, 0.5f, 6.0f, 2.5f};
+  filter.outlierThreshold = 100.0f;
+  addRanges(ranges, 8);
+
+  // Test
+  // Assert
+  float expected[] = {0.5f, 2.0f, 2.5f, 3.0f, 6.0f};
+  for (int i = 0; i < DW_RANGE_FILTER_WINDOW; i++) {
+    TEST_ASSERT_EQUAL_FLOAT(expected[i], filter.sorted[i]);
+  }
+}
+
+void testThatKalmanFilterEstimatesVelocity() {
+  // Fixture
+  filter.kalman = true;
+
+  // Test
+  for (int i = 0; i < 100; i++) {
+    float time = i * 0.1f;
+    dwRangeFilterUpdate(&filter, 10.0f + 1.5f * time, time, 0.0f);
+  }
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 1.5f, filter.velocity);
+  TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f + 1.5f * 9.9f, filter.range);
+}
+
+void testThatResetKeepsConfiguration() {
+  // Fixture
+  filter.kalman = true;
+  filter.maxPowerDifference = 6.0f;
+  dwRangeFilterUpdate(&filter, 2.0f, 0.0f, 0.0f);
+
+  // Test
+  dwRangeFilterReset(&filter);
+
+  // Assert
+  TEST_ASSERT_FALSE(filter.valid);
+  TEST_ASSERT_EQUAL_UINT8(0, filter.count);
+  TEST_ASSERT_TRUE(filter.kalman);
+  TEST_ASSERT_EQUAL_FLOAT(6.0f, filter.maxPowerDifference);
+}
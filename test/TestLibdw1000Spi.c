@@ -237,6 +237,66 @@ void testThatDwSpiWriteHeaderIsCorrectForAddress0xffff() {
 }
 
 
+static void verifyThatPrecomputedHeaderIsCorrect(uint8_t regid, uint32_t address) {
+  // Fixture
+  dwSpiHeader_t readHeader = DW_SPI_HEADER_READ(regid, address);
+  dwSpiHeader_t writeHeader = DW_SPI_HEADER_WRITE(regid, address);
+
+  // Test
+  dwSpiRead(&dev, regid, address, NULL, 0);
+  dwSpiWrite(&dev, regid, address, NULL, 0);
+
+  // Assert
+  TEST_ASSERT_EQUAL(readListenerHeaderLength, readHeader.length);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(readListenerHeader, readHeader.bytes, readHeader.length);
+  TEST_ASSERT_EQUAL(writeListenerHeaderLength, writeHeader.length);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(writeListenerHeader, writeHeader.bytes, writeHeader.length);
+}
+
+
+void testThatPrecomputedHeaderMatchesBuiltHeaderForAddresses() {
+  verifyThatPrecomputedHeaderIsCorrect(0x0f, 0x00);
+  verifyThatPrecomputedHeaderIsCorrect(0x15, 0x01);
+  verifyThatPrecomputedHeaderIsCorrect(0x36, 0x7f);
+  verifyThatPrecomputedHeaderIsCorrect(0x2e, 0x0806);
+  verifyThatPrecomputedHeaderIsCorrect(0xff, 0xffff);
+}
+
+
+void testThatDwSpiReadHeaderPassesHeaderOn() {
+  // Fixture
+  static const dwSpiHeader_t header = DW_SPI_HEADER_READ(0x0f, 0x03);
+  uint8_t expectedHeader[] = {0x4f, 0x03};
+  uint8_t data[2];
+  nextReadData = NULL;
+
+  // Test
+  dwSpiReadHeader(&dev, &header, data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedHeader, readListenerHeader, sizeof(expectedHeader));
+  TEST_ASSERT_EQUAL(sizeof(expectedHeader), readListenerHeaderLength);
+  TEST_ASSERT_EQUAL_UINT((size_t)data, (size_t)readListenerData);
+  TEST_ASSERT_EQUAL_UINT(sizeof(data), readListenerDataLength);
+}
+
+
+void testThatDwSpiWriteHeaderPassesHeaderOn() {
+  // Fixture
+  static const dwSpiHeader_t header = DW_SPI_HEADER_WRITE(0x0d, 0x00);
+  uint8_t expectedHeader[] = {0x8d};
+  uint32_t data = 0;
+
+  // Test
+  dwSpiWriteHeader(&dev, &header, &data, sizeof(data));
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expectedHeader, writeListenerHeader, sizeof(expectedHeader));
+  TEST_ASSERT_EQUAL(sizeof(expectedHeader), writeListenerHeaderLength);
+  TEST_ASSERT_EQUAL_UINT((size_t)&data, (size_t)writeListenerData);
+}
+
+
 void testThatDwSpiWrite32PassesDataOn() {
   // Fixture
 
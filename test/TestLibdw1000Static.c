@@ -5,63 +5,51 @@
 // Include c file to test static functions
 #include "libdw1000.c"
 
-void testThatGetBitReturnsFirstBitWhenSet() {
+void testThatSetBitsSetsMaskedBits() {
   // Fixture
-  uint8_t data[] = {0x01};
+  uint32_t reg = 0x00000001;
 
   // Test
-  bool actual = getBit(data, 1, 0);
+  setBits(&reg, 0x80000100, true);
 
   // Assert
-  TEST_ASSERT_EQUAL(true, actual);
+  TEST_ASSERT_EQUAL_HEX32(0x80000101, reg);
 }
 
 
-void testThatGetBitReturnsFirstBitWhenNotSet() {
+void testThatSetBitsClearsMaskedBits() {
   // Fixture
-  uint8_t data[] = {0};
+  uint32_t reg = 0xffffffff;
 
   // Test
-  bool actual = getBit(data, 1, 0);
+  setBits(&reg, 0x80000100, false);
 
   // Assert
-  TEST_ASSERT_EQUAL(false, actual);
+  TEST_ASSERT_EQUAL_HEX32(0x7ffffeff, reg);
 }
 
 
-void testThatGetBitReturnsBit7() {
+void testThatReceiveFailedIsDetectedFromAnyRxError() {
   // Fixture
-  uint8_t data[] = {0x80};
+  dwDevice_t dev = {.sysstatus = 1ull << AFFREJ_BIT};
 
   // Test
-  bool actual = getBit(data, 1, 7);
+  bool actual = dwIsReceiveFailed(&dev);
 
   // Assert
   TEST_ASSERT_EQUAL(true, actual);
 }
 
 
-void testThatGetBitReturnsBit8() {
+void testThatReceiveFailedIsNotDetectedFromRxGood() {
   // Fixture
-  uint8_t data[] = {0x00, 0x01};
+  dwDevice_t dev = {.sysstatus = SYS_STATUS_ALL_RX_GOOD};
 
   // Test
-  bool actual = getBit(data, 2, 8);
+  bool actual = dwIsReceiveFailed(&dev);
 
   // Assert
-  TEST_ASSERT_EQUAL(true, actual);
-}
-
-
-void testThatGetBitReturnsBit9() {
-  // Fixture
-  uint8_t data[] = {0x00, 0x02};
-
-  // Test
-  bool actual = getBit(data, 2, 9);
-
-  // Assert
-  TEST_ASSERT_EQUAL(true, actual);
+  TEST_ASSERT_EQUAL(false, actual);
 }
 
 
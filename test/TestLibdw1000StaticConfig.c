@@ -0,0 +1,139 @@
+#define DW_STATIC_CONFIG
+
+#include <string.h>
+
+#include "unity.h"
+
+#include "mock_libdw1000Spi.h"
+
+// Include c file to build the driver with the static configuration
+#include "libdw1000.c"
+
+// Register file of a fake chip, indexed by register id and sub-address
+#define REGISTER_SPACE 0x2900
+
+static uint8_t registers[0x40][REGISTER_SPACE];
+static uint8_t runtimeImage[0x40][REGISTER_SPACE];
+
+static dwDevice_t dev;
+
+static void fakeDelayms(dwDevice_t* dev, unsigned int delay) {
+  (void)dev;
+  (void)delay;
+}
+
+static void fakeSpiSetSpeed(dwDevice_t* dev, dwSpiSpeed_t speed) {
+  (void)dev;
+  (void)speed;
+}
+
+static dwOps_t ops = {
+  .spiSetSpeed = fakeSpiSetSpeed,
+  .delayms = fakeDelayms,
+};
+
+static void decodeHeader(const dwSpiHeader_t* header, uint8_t* regid, uint32_t* address) {
+  *regid = header->bytes[0] & 0x3f;
+  *address = 0;
+  if (header->bytes[0] & 0x40) {
+    *address = header->bytes[1] & 0x7f;
+    if (header->bytes[1] & 0x80) {
+      *address |= (uint32_t)header->bytes[2] << 7;
+    }
+  }
+}
+
+static void dwSpiRead_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, void* data, size_t length, int cmock_num_calls) {
+  TEST_ASSERT_TRUE(address + length <= REGISTER_SPACE);
+  memcpy(data, &registers[regid][address], length);
+}
+
+static void dwSpiWrite_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, const void* data, size_t length, int cmock_num_calls) {
+  TEST_ASSERT_TRUE(address + length <= REGISTER_SPACE);
+  memcpy(&registers[regid][address], data, length);
+}
+
+static void dwSpiReadHeader_fake(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  uint8_t regid;
+  uint32_t address;
+  decodeHeader(header, &regid, &address);
+  dwSpiRead_fake(dev, regid, address, data, length, cmock_num_calls);
+}
+
+static void dwSpiWriteHeader_fake(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls) {
+  uint8_t regid;
+  uint32_t address;
+  decodeHeader(header, &regid, &address);
+  dwSpiWrite_fake(dev, regid, address, data, length, cmock_num_calls);
+}
+
+static uint16_t dwSpiRead16_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, int cmock_num_calls) {
+  uint16_t data;
+  dwSpiRead_fake(dev, regid, address, &data, sizeof(data), cmock_num_calls);
+  return data;
+}
+
+static uint32_t dwSpiRead32_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, int cmock_num_calls) {
+  uint32_t data;
+  dwSpiRead_fake(dev, regid, address, &data, sizeof(data), cmock_num_calls);
+  return data;
+}
+
+static void dwSpiWrite8_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, uint8_t data, int cmock_num_calls) {
+  dwSpiWrite_fake(dev, regid, address, &data, sizeof(data), cmock_num_calls);
+}
+
+static void dwSpiWrite32_fake(dwDevice_t* dev, uint8_t regid, uint32_t address, uint32_t data, int cmock_num_calls) {
+  dwSpiWrite_fake(dev, regid, address, &data, sizeof(data), cmock_num_calls);
+}
+
+static void resetChip() {
+  uint32_t deviceId = 0xdeca0130;
+  memset(registers, 0, sizeof(registers));
+  memcpy(&registers[DEV_ID][0], &deviceId, sizeof(deviceId));
+}
+
+void setUp() {
+  dwSpiRead_StubWithCallback(dwSpiRead_fake);
+  dwSpiWrite_StubWithCallback(dwSpiWrite_fake);
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_fake);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_fake);
+  dwSpiRead16_StubWithCallback(dwSpiRead16_fake);
+  dwSpiRead32_StubWithCallback(dwSpiRead32_fake);
+  dwSpiWrite8_StubWithCallback(dwSpiWrite8_fake);
+  dwSpiWrite32_StubWithCallback(dwSpiWrite32_fake);
+}
+
+void testThatStaticConfigurationWritesTheRuntimeDefaultImage() {
+  // Fixture
+  resetChip();
+  dwInit(&dev, &ops);
+  TEST_ASSERT_EQUAL(DW_ERROR_OK, dwConfigure(&dev));
+  dwSetDefaults(&dev);
+  dwCommitConfiguration(&dev);
+  memcpy(runtimeImage, registers, sizeof(registers));
+  resetChip();
+  dwInit(&dev, &ops);
+
+  // Test
+  int actual = dwConfigureStatic(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_ERROR_OK, actual);
+  for (int regid = 0; regid < 0x40; regid++) {
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(runtimeImage[regid], registers[regid], REGISTER_SPACE);
+  }
+}
+
+void testThatStaticConfigurationLeavesTheFrameLengthToSetData() {
+  // Fixture
+  resetChip();
+  dwInit(&dev, &ops);
+
+  // Test
+  dwConfigureStatic(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL_HEX8(0, registers[TX_FCTRL][0]);
+  TEST_ASSERT_EQUAL_HEX8(0, dev.txfctrl[0]);
+}
@@ -0,0 +1,157 @@
+#include "unity.h"
+#include "libdw1000TagTable.h"
+#include "libdw1000RangeFilter.h"
+#include "libdw1000Hash.h"
+
+static dwTagTable_t table;
+
+void setUp() {
+  dwTagTableInit(&table);
+}
+
+void testThatUnknownTagIsNotFound() {
+  // Fixture
+
+  // Test
+  int actual = dwTagTableFind(&table, 0x1234);
+
+  // Assert
+  TEST_ASSERT_EQUAL(-1, actual);
+}
+
+void testThatInsertedTagIsFound() {
+  // Fixture
+  int index = dwTagTableInsert(&table, 0x0102030405060708ull);
+  table.sequence[index] = 42;
+
+  // Test
+  int actual = dwTagTableFind(&table, 0x0102030405060708ull);
+
+  // Assert
+  TEST_ASSERT_EQUAL(index, actual);
+  TEST_ASSERT_EQUAL_UINT8(42, table.sequence[actual]);
+  TEST_ASSERT_EQUAL(1, table.count);
+}
+
+void testThatInsertingKnownTagReturnsItsEntry() {
+  // Fixture
+  int index = dwTagTableInsert(&table, 0x1234);
+  table.sequence[index] = 7;
+
+  // Test
+  int actual = dwTagTableInsert(&table, 0x1234);
+
+  // Assert
+  TEST_ASSERT_EQUAL(index, actual);
+  TEST_ASSERT_EQUAL_UINT8(7, table.sequence[actual]);
+  TEST_ASSERT_EQUAL(1, table.count);
+}
+
+void testThatShortAndLongAddressesAreDifferentTags() {
+  // Fixture
+  dwTagTableInsert(&table, 0x1234);
+
+  // Test
+  int actual = dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(0x1234));
+
+  // Assert
+  TEST_ASSERT_EQUAL(-1, actual);
+}
+
+void testThatInsertFailsWhenTableIsFull() {
+  // Fixture
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    TEST_ASSERT_TRUE(dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(i)) >= 0);
+  }
+
+  // Test
+  int actual = dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(0xbeef));
+
+  // Assert
+  TEST_ASSERT_EQUAL(-1, actual);
+}
+
+void testThatReservedAddressIsNotInserted() {
+  // Fixture
+
+  // Test
+  int actual = dwTagTableInsert(&table, DW_HASH_EMPTY);
+
+  // Assert
+  TEST_ASSERT_EQUAL(-1, actual);
+  TEST_ASSERT_EQUAL(0, table.count);
+}
+
+void testThatAllTagsAreFoundWhenTableIsFull() {
+  // Fixture
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    int index = dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(i));
+    table.range[index] = (float)i;
+  }
+
+  // Test
+  // Assert
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    int index = dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(i));
+    TEST_ASSERT_TRUE(index >= 0);
+    TEST_ASSERT_EQUAL_FLOAT((float)i, table.range[index]);
+  }
+}
+
+void testThatRemovedTagIsNotFoundAndOthersAre() {
+  // Fixture
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    int index = dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(i));
+    table.range[index] = (float)i;
+  }
+
+  // Test
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i += 2) {
+    dwTagTableRemove(&table, dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(i)));
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL(DW_TAG_TABLE_CAPACITY / 2, table.count);
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    int index = dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(i));
+    if (i % 2 == 0) {
+      TEST_ASSERT_EQUAL(-1, index);
+    } else {
+      TEST_ASSERT_TRUE(index >= 0);
+      TEST_ASSERT_EQUAL_FLOAT((float)i, table.range[index]);
+    }
+  }
+}
+
+void testThatRemoveIgnoresInvalidIndex() {
+  // Fixture
+  dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(1));
+
+  // Test
+  dwTagTableRemove(&table, -1);
+  dwTagTableRemove(&table, DW_TAG_TABLE_SIZE);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, table.count);
+}
+
+void testThatRangeFilterFollowsItsTag() {
+  // Fixture
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i++) {
+    int index = dwTagTableInsert(&table, DW_TAG_SHORT_ADDRESS(i));
+    TEST_ASSERT_FALSE(table.filter[index].valid);
+    dwRangeFilterUpdate(&table.filter[index], (float)i, 0.0f, 0.0f);
+  }
+
+  // Test
+  for (int i = 0; i < DW_TAG_TABLE_CAPACITY; i += 2) {
+    dwTagTableRemove(&table, dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(i)));
+  }
+
+  // Assert
+  for (int i = 1; i < DW_TAG_TABLE_CAPACITY; i += 2) {
+    int index = dwTagTableFind(&table, DW_TAG_SHORT_ADDRESS(i));
+    TEST_ASSERT_TRUE(table.filter[index].valid);
+    TEST_ASSERT_EQUAL_FLOAT((float)i, table.filter[index].range);
+  }
+}
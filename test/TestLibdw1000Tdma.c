@@ -0,0 +1,212 @@
+#include <string.h>
+#include "unity.h"
+#include "libdw1000.h"
+#include "libdw1000Tdma.h"
+
+#include "mock_libdw1000Spi.h"
+
+static dwOps_t ops;
+static dwDevice_t dev;
+static dwTdma_t tdma;
+
+static const uint64_t start = 0x1000000000ull;
+static const uint64_t slotLength = 0x4000000ull;
+static const uint64_t guard = 0x10000ull;
+
+// Register values seen by the fake SPI
+static uint64_t status;
+static uint64_t dxTime;
+static int dxTimeWrites;
+static int preparedSlot;
+static int prepareCount;
+// Number of delayed TX or RX reported as late (HPDWARN)
+static int lateReports;
+
+static void dwSpiReadHeader_fake(dwDevice_t* dev, const dwSpiHeader_t* header, void* data, size_t length, int cmock_num_calls) {
+  memset(data, 0, length);
+  if ((header->bytes[0] & 0x3f) == SYS_STATUS && header->length == 1) {
+    memcpy(data, &status, length);
+  }
+  if ((header->bytes[0] & 0x3f) == SYS_STATUS && header->length == 2 && lateReports > 0) {
+    ((uint8_t*)data)[0] = 1 << (HPDWARN_BIT - 24);
+    lateReports--;
+  }
+}
+
+static void dwSpiWriteHeader_fake(dwDevice_t* dev, const dwSpiHeader_t* header, const void* data, size_t length, int cmock_num_calls) {
+  if ((header->bytes[0] & 0x3f) == DX_TIME) {
+    dxTime = 0;
+    memcpy(&dxTime, data, length);
+    dxTimeWrites++;
+  }
+}
+
+static unsigned int prepareTx(dwTdma_t *tdma, uint8_t slot, uint8_t data[]) {
+  preparedSlot = slot;
+  prepareCount++;
+  data[0] = slot;
+  return 1;
+}
+
+static void initSuperframe(dwTdmaSuperframe_t *superframe, const dwTdmaSlot_t *slots, uint8_t slotCount) {
+  superframe->slots = slots;
+  superframe->slotCount = slotCount;
+  superframe->slotLength.full = slotLength;
+  superframe->guard.full = guard;
+  superframe->syncOwner = 0;
+}
+
+void setUp() {
+  dwInit(&dev, &ops);
+  status = 0;
+  dxTime = 0;
+  dxTimeWrites = 0;
+  preparedSlot = -1;
+  prepareCount = 0;
+  lateReports = 0;
+
+  dwSpiReadHeader_StubWithCallback(dwSpiReadHeader_fake);
+  dwSpiWriteHeader_StubWithCallback(dwSpiWriteHeader_fake);
+  dwSpiWrite_Ignore();
+  dwSpiRead_Ignore();
+}
+
+void testThatNextSlotSkipsIdleSlots() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotTx, 1}, {dwTdmaSlotIdle, 0}, {dwTdmaSlotRx, 2}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 3);
+  unsigned int distance;
+
+  // Test
+  uint8_t actual = dwTdmaNextSlot(&superframe, 0, &distance);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(2, actual);
+  TEST_ASSERT_EQUAL(2, distance);
+}
+
+void testThatNextSlotWrapsAroundSuperframe() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotIdle, 0}, {dwTdmaSlotTx, 1}, {dwTdmaSlotIdle, 0}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 3);
+  unsigned int distance;
+
+  // Test
+  uint8_t actual = dwTdmaNextSlot(&superframe, 1, &distance);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT8(1, actual);
+  TEST_ASSERT_EQUAL(3, distance);
+}
+
+void testThatTxSlotIsProgrammedAtSlotStart() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotTx, 1}, {dwTdmaSlotIdle, 0}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 2);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+
+  // Test
+  dwTdmaStart(&tdma, startTime);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(start, dxTime);
+  TEST_ASSERT_EQUAL(0, preparedSlot);
+  TEST_ASSERT_EQUAL(1, dxTimeWrites);
+}
+
+void testThatRxSlotOpensReceiverBeforePreambleAndQueuesNextFrame() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotRx, 0}, {dwTdmaSlotTx, 1}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 2);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+  uint64_t expected = (start - dwGetPreambleDuration(&dev).full - guard) & ~0x1ffull;
+
+  // Test
+  dwTdmaStart(&tdma, startTime);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(expected, dxTime);
+  TEST_ASSERT_EQUAL(RX_MODE, dev.deviceMode);
+  TEST_ASSERT_EQUAL(1, preparedSlot);
+  TEST_ASSERT_TRUE(tdma.txLoaded);
+}
+
+void testThatLateRxSlotIsCountedAndSkipped() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotRx, 0}, {dwTdmaSlotTx, 1}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 2);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+  lateReports = 1;
+
+  // Test
+  dwTdmaStart(&tdma, startTime);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, tdma.missedSlots);
+  TEST_ASSERT_EQUAL_UINT8(1, tdma.slot);
+  TEST_ASSERT_EQUAL_UINT64(start + slotLength, dxTime);
+  TEST_ASSERT_TRUE(tdma.running);
+}
+
+void testThatSentEventProgramsNextActiveSlot() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotTx, 1}, {dwTdmaSlotIdle, 0}, {dwTdmaSlotTx, 1}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 3);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+  dwTdmaStart(&tdma, startTime);
+  status = 1ull << TXFRS_BIT;
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(start + 2 * slotLength, dxTime);
+  TEST_ASSERT_EQUAL_UINT8(2, tdma.slot);
+  TEST_ASSERT_EQUAL(2, prepareCount);
+}
+
+void testThatStoppedSchedulerIgnoresEvents() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotTx, 1}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 1);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+  dwTdmaStart(&tdma, startTime);
+  dwTdmaStop(&tdma);
+  status = 1ull << TXFRS_BIT;
+
+  // Test
+  dwHandleInterrupt(&dev);
+
+  // Assert
+  TEST_ASSERT_EQUAL(1, dxTimeWrites);
+  TEST_ASSERT_EQUAL(IDLE_MODE, dev.deviceMode);
+}
+
+void testThatSuperframeOfIdleSlotsStopsWithoutTransmitting() {
+  // Fixture
+  dwTdmaSlot_t slots[] = {{dwTdmaSlotIdle, 0}, {dwTdmaSlotIdle, 0}};
+  dwTdmaSuperframe_t superframe;
+  initSuperframe(&superframe, slots, 2);
+  dwTdmaInit(&tdma, &dev, &superframe, prepareTx, NULL);
+  dwTime_t startTime = {.full = start};
+
+  // Test
+  dwTdmaStart(&tdma, startTime);
+
+  // Assert
+  TEST_ASSERT_EQUAL(0, prepareCount);
+  TEST_ASSERT_EQUAL(0, dxTimeWrites);
+  TEST_ASSERT_FALSE(tdma.running);
+}
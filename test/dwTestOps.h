@@ -14,6 +14,7 @@
 
   void spiSetSpeed(dwDevice_t* dev, dwSpiSpeed_t speed);
   void delayms(dwDevice_t* dev, unsigned int delay);
+  void delayus(dwDevice_t* dev, unsigned int delay);
   void reset(dwDevice_t *dev);
 
 #endif // __DW_TEST_OPS_H__